@@ -443,6 +443,66 @@ DeploymentScenario aToDeploymentScenario(std::string s)
     return UNKNOW_SCENARIO;
 }
 
+RbMap::RbMap(const RbTreeMap& map) : bands_(0)
+{
+    RbTreeMap::const_iterator it = map.begin(), et = map.end();
+    for (; it != et; ++it)
+    {
+        std::map<Band, unsigned int>::const_iterator jt = it->second.begin(), jet = it->second.end();
+        if (jt == jet)
+            resize(it->first, 0);
+        for (; jt != jet; ++jt)
+            set(it->first, jt->first, jt->second);
+    }
+}
+
+RbTreeMap RbMap::toTreeMap() const
+{
+    RbTreeMap map;
+    for (unsigned int r = 0; r < NUM_ANTENNAS; r++)
+    {
+        if (!remotes_.test(r))
+            continue;
+        std::map<Band, unsigned int>& bands = map[(Remote)r];
+        for (Band b = 0; b < bands_; b++)
+            bands[b] = blocks_[r * bands_ + b];
+    }
+    return map;
+}
+
+unsigned int RbMap::at(Remote antenna, Band band) const
+{
+    if (!hasRemote(antenna) || band >= bands_)
+        throw cRuntimeError("RbMap::at - no blocks for remote %s and band %d", dasToA(antenna).c_str(), band);
+    return blocks_[antenna * bands_ + band];
+}
+
+void RbMap::resize(Remote antenna, Band band)
+{
+    if (antenna >= NUM_ANTENNAS)
+        throw cRuntimeError("RbMap::resize - invalid remote %d", antenna);
+
+    unsigned int bands = std::max(bands_, (unsigned int)band + 1);
+    unsigned int remotes = blocks_.empty() ? 0 : blocks_.size() / bands_;
+    remotes = std::max(remotes, (unsigned int)antenna + 1);
+
+    if (bands != bands_ && blocks_.size() > bands_)
+    {
+        // more than one Remote is stored, move the blocks to the new layout
+        std::vector<unsigned int> blocks(remotes * bands, 0);
+        for (unsigned int r = 0; r < blocks_.size() / bands_; r++)
+            std::copy(blocks_.begin() + r * bands_, blocks_.begin() + (r + 1) * bands_, blocks.begin() + r * bands);
+        blocks_.swap(blocks);
+    }
+    else
+    {
+        // blocks of the first Remote are a prefix of the array
+        blocks_.resize(remotes * bands, 0);
+    }
+    bands_ = bands;
+    remotes_.set(antenna);
+}
+
 bool isMulticastConnection(LteControlInfo* lteInfo)
 {
     return (lteInfo->getMulticastGroupId() >= 0);
@@ -544,21 +604,17 @@ cModule* getMacByMacNodeId(MacNodeId nodeId)
 {
     // UE might have left the simulation, return NULL in this case
     // since we do not have a MAC-Module anymore
-	int id = getBinder()->getOmnetId(nodeId);
-	if (id == 0){
+	LteBinder* binder = getBinder();
+	if (binder->getOmnetId(nodeId) == 0){
 		return NULL;
 	}
 	// TODO fix for relays
-	return (getSimulation()->getModule(getBinder()->getOmnetId(nodeId))->getSubmodule("lteNic")->getSubmodule("mac"));
+	return binder->getMacFromMacNodeId(nodeId);
 }
 
 cModule* getRlcByMacNodeId(MacNodeId nodeId, LteRlcType rlcType)
 {
-	cModule* module = getMacByMacNodeId(nodeId);
-	if(module == NULL){
-		return NULL;
-	}
-    return getMacByMacNodeId(nodeId)->getParentModule()->getSubmodule("rlc")->getSubmodule(rlcTypeToA(rlcType).c_str());
+    return getBinder()->getRlcByMacNodeId(nodeId, rlcType);
 }
 
 LteBinder* getBinder()
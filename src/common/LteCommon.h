@@ -452,10 +452,92 @@ const unsigned char NUM_RUS = RU6;
  */
 const unsigned char NUM_ANTENNAS = NUM_RUS + 1;
 
+/**
+ *  Tree form of the block allocation Map: # of Rbs per Band, per Remote.
+ */
+typedef std::map<Remote, std::map<Band, unsigned int> > RbTreeMap;
+
 /**
  *  Block allocation Map: # of Rbs per Band, per Remote.
+ *
+ *  The blocks of all the Remotes are stored in one contiguous array, with
+ *  the same number of Bands for each Remote. Bands that have never been
+ *  set hold zero blocks. Copying the map costs a single allocation, and
+ *  reading it does not modify it.
  */
-typedef std::map<Remote, std::map<Band, unsigned int> > RbMap;
+class RbMap
+{
+    // Remotes present in the map
+    std::bitset<NUM_ANTENNAS> remotes_;
+    // number of Bands stored for each Remote
+    unsigned int bands_;
+    // blocks, indexed by remote * bands_ + band
+    std::vector<unsigned int> blocks_;
+
+    // makes room for the given Remote and Band
+    void resize(Remote antenna, Band band);
+
+  public:
+    RbMap() : bands_(0) {}
+
+    /**
+     * Conversion from and to the tree form
+     */
+    explicit RbMap(const RbTreeMap& map);
+    RbTreeMap toTreeMap() const;
+
+    /**
+     * Returns the blocks allocated on the given Remote and Band,
+     * zero if they have never been set
+     */
+    unsigned int get(Remote antenna, Band band) const
+    {
+        if (antenna >= NUM_ANTENNAS || !remotes_.test(antenna) || band >= bands_)
+            return 0;
+        return blocks_[antenna * bands_ + band];
+    }
+
+    /**
+     * As get(), but throws an error if the Remote or the Band are not in the map
+     */
+    unsigned int at(Remote antenna, Band band) const;
+
+    void set(Remote antenna, Band band, unsigned int blocks)
+    {
+        if (antenna >= NUM_ANTENNAS || !remotes_.test(antenna) || band >= bands_)
+            resize(antenna, band);
+        blocks_[antenna * bands_ + band] = blocks;
+    }
+
+    bool hasRemote(Remote antenna) const
+    {
+        return antenna < NUM_ANTENNAS && remotes_.test(antenna);
+    }
+
+    /**
+     * Returns true if blocks are allocated on the given Band on any Remote
+     */
+    bool isBandUsed(Band band) const
+    {
+        for (unsigned int r = 0; r < NUM_ANTENNAS; ++r)
+            if (get((Remote)r, band) > 0)
+                return true;
+        return false;
+    }
+
+    // number of Remotes in the map
+    unsigned int getNumRemotes() const { return remotes_.count(); }
+
+    // number of Bands stored for each Remote
+    unsigned int getNumBands() const { return bands_; }
+
+    void clear()
+    {
+        remotes_.reset();
+        bands_ = 0;
+        blocks_.clear();
+    }
+};
 
 /**
  * Lte PHY Frame Types
@@ -804,6 +886,8 @@ struct UeAllocationInfo{
     MacCellId cellId;
     LtePhyBase* phy;
     Direction dir;
+    // tx power (dBm) of the UE in the direction above
+    double txPower;
 };
 
 typedef std::vector<ExtCell*> ExtCellList;
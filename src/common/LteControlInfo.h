@@ -79,12 +79,12 @@ class UserControlInfo : public UserControlInfo_Base
 
     const unsigned int getBlocks(Remote antenna, Band b) const
         {
-        return grantedBlocks.at(antenna).at(b);
+        return grantedBlocks.at(antenna, b);
     }
 
     void setBlocks(Remote antenna, Band b, const unsigned int blocks)
     {
-        grantedBlocks[antenna][b] = blocks;
+        grantedBlocks.set(antenna, b, blocks);
     }
 
     const RbMap& getGrantedBlocks() const
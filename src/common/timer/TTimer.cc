@@ -18,6 +18,7 @@ void TTimer::start(simtime_t t)
     intr_ = new TTimerMsg("timer");
     intr_->setType(TTSIMPLE);
     intr_->setTimerId(timerId_);
+    intr_->setContextPointer(contextPointer_);
     module_->scheduleAt(t + NOW, intr_);
     busy_ = true;
     start_ = NOW;
@@ -77,6 +78,7 @@ void TMultiTimer::add(const simtime_t time, const unsigned int event)
         intr_ = new TMultiTimerMsg("timer");
         intr_->setType(TTMULTI);
         intr_->setTimerId(timerId_);
+        intr_->setContextPointer(contextPointer_);
         intr_->setEvent(event);
         module_->scheduleAt(time + NOW, intr_);
     }
@@ -124,6 +126,7 @@ void TMultiTimer::handle(unsigned int event)
 
         intr_ = new TMultiTimerMsg("timer");
         intr_->setTimerId(timerId_);
+        intr_->setContextPointer(contextPointer_);
         intr_->setType(TTMULTI);
         intr_->setEvent(event);
         module_->scheduleAt(time, intr_);
@@ -163,6 +166,7 @@ void TMultiTimer::remove(const unsigned int event)
             unsigned int event = directList_.begin()->second;
             intr_ = new TMultiTimerMsg("timer");
             intr_->setTimerId(timerId_);
+            intr_->setContextPointer(contextPointer_);
             intr_->setType(TTMULTI);
             intr_->setEvent(event);
             module_->scheduleAt(time, intr_);
@@ -176,3 +180,13 @@ void TMultiTimer::remove(const unsigned int event)
     // Remove the Event from the reverse list
     reverseList_.erase(rIt);
 }
+
+void TMultiTimer::clear()
+{
+    if (busy_)
+        module_->cancelAndDelete(intr_);
+
+    directList_.clear();
+    reverseList_.clear();
+    busy_ = false;
+}
@@ -27,6 +27,7 @@ class TTimer : public omnetpp::cObject
     TTimer(omnetpp::cSimpleModule* module)
     {
         module_ = module;
+        contextPointer_ = NULL;
         busy_ = false;
         start_ = 0;
         expire_ = 0;
@@ -77,6 +78,17 @@ class TTimer : public omnetpp::cObject
         this->timerId_ = timerId_;
     }
 
+    /*!
+     * Sets the context pointer of the messages scheduled by the timer,
+     * so that a module handling the timers of several objects can dispatch them
+     *
+     * @param contextPointer the context pointer
+     */
+    void setContextPointer(void* contextPointer)
+    {
+        contextPointer_ = contextPointer;
+    }
+
     /*! Return true if the timer is busy.
      *
      * @return whether the timer is busy or not
@@ -120,6 +132,9 @@ class TTimer : public omnetpp::cObject
     //! Object for handling the event.
     omnetpp::cSimpleModule* module_;
 
+    //! Context pointer of the timer messages
+    void* contextPointer_;
+
     //! Used for scheduling an event into the Omnet++ event scheduler
     TTimerMsg * intr_;
 
@@ -148,6 +163,7 @@ class TMultiTimer : public omnetpp::cObject
     TMultiTimer(omnetpp::cSimpleModule* module)
     {
         module_ = module;
+        contextPointer_ = NULL;
         busy_ = false;
         timerId_ = 0;
     }
@@ -183,12 +199,27 @@ class TMultiTimer : public omnetpp::cObject
         this->timerId_ = timerId_;
     }
 
+    /*!
+     * Sets the context pointer of the messages scheduled by the timer,
+     * so that a module handling the timers of several objects can dispatch them
+     *
+     * @param contextPointer the context pointer
+     */
+    void setContextPointer(void* contextPointer)
+    {
+        contextPointer_ = contextPointer;
+    }
+
     /*! Remove an event. Note that event id are assumed to be unique
      *
      * @param event event to be removed
      */
     virtual void remove(const unsigned int event);
 
+    /*! Remove all the events. The multi-timer is now idle.
+     */
+    virtual void clear();
+
     /*!
      * Callback to signal the timer event handled by connected simpleModule
      * @param event event to be signaled
@@ -227,6 +258,9 @@ class TMultiTimer : public omnetpp::cObject
     //! Object for handling the event.
     omnetpp::cSimpleModule* module_;
 
+    //! Context pointer of the timer messages
+    void* contextPointer_;
+
     //! Used for scheduling an event into the Omnet++ event scheduler
     TMultiTimerMsg* intr_;
 
@@ -8,6 +8,8 @@
 //
 
 #include "corenetwork/binder/LteBinder.h"
+#include "stack/phy/layer/LtePhyBase.h"
+#include "stack/pdcp_rrc/layer/LtePdcpRrc.h"
 #include "inet/networklayer/common/L3AddressResolver.h"
 #include <cctype>
 
@@ -44,15 +46,18 @@ void LteBinder::unregisterNode(MacNodeId id)
         mac->unregisterHarqBufferRx(id);
     }
 
-    // remove 'id' from LteMacBase* cache but do not delte pointer.
-    if(macNodeIdToModule_.erase(id) != 1){
-        EV_ERROR << "Cannot unregister node - node id \"" << id << "\" - not found";
-    }
-
-    // remove 'id' from MacNodeId mapping
+    // remove 'id' from MacNodeId mapping and from the registry (the LteMacBase* is not deleted)
     if(nodeIds_.erase(id) != 1){
         EV_ERROR << "Cannot unregister node - node id \"" << id << "\" - not found";
     }
+    if (id < nodeRegistry_.size())
+        nodeRegistry_[id] = NodeEntry();
+
+    // remove 'id' from the spatial index
+    removeNodePosition(id);
+
+    // stop driving the MAC and the feedback generator of 'id'
+    ttiClock_.unregisterClients(id);
 }
 
 MacNodeId LteBinder::registerNode(cModule *module, LteNodeType type,
@@ -83,6 +88,12 @@ MacNodeId LteBinder::registerNode(cModule *module, LteNodeType type,
 
     nodeIds_[macNodeId] = module->getId();
 
+    if (nodeRegistry_.size() <= macNodeId)
+        nodeRegistry_.resize(macNodeId + 1);
+    nodeRegistry_[macNodeId] = NodeEntry();
+    nodeRegistry_[macNodeId].omnetId = module->getId();
+    nodeRegistry_[macNodeId].type = type;
+
     module->par("macNodeId") = macNodeId;
 
     if (type == RELAY || type == UE)
@@ -118,6 +129,55 @@ void LteBinder::initialize(int stage)
     if (stage == inet::INITSTAGE_LOCAL)
     {
         numBands_ = par("numBands");
+
+        interferenceCutoffDistance_ = par("interferenceCutoffDistance");
+        coordinatedScheduling_ = par("coordinatedScheduling");
+        globalTtiClock_ = par("globalTtiClock");
+        recordEventRate_ = par("recordEventRate");
+        double cellSize = par("spatialIndexCellSize");
+        enbPositions_.setCellSize(cellSize);
+        uePositions_.setCellSize(cellSize);
+        if (isExtCellInterferenceMap())
+            extCellInterferenceMap_.setResolution(getExtCellInterferenceMapResolution());
+
+        if (globalTtiClock_)
+        {
+            // same timing as the TTI ticks of the MAC layers
+            ttiClockTick_ = new cMessage("ttiClockTick");
+            ttiClockTick_->setSchedulingPriority(1);
+            scheduleAt(NOW + TTI, ttiClockTick_);
+        }
+    }
+}
+
+void LteBinder::handleMessage(cMessage *msg)
+{
+    if (msg == ttiClockTick_)
+    {
+        ttiClock_.tick();
+        scheduleAt(NOW + TTI, ttiClockTick_);
+    }
+}
+
+void LteBinder::finish()
+{
+    if (globalTtiClock_)
+    {
+        recordScalar("ttiClockClients", ttiClock_.size());
+        recordScalar("ttiClockDispatchedTtis", ttiClock_.getDispatchedTtis());
+    }
+    if (isExtCellInterferenceMap())
+    {
+        recordScalar("extCellInterferenceMapSamples", extCellInterferenceMap_.getSamples());
+        recordScalar("extCellInterferenceMapPixels", extCellInterferenceMap_.getComputedPixels());
+    }
+    if (recordEventRate_)
+    {
+        // events taken from the future event set, including the ones of the binder itself
+        double events = getSimulation()->getEventNumber();
+        recordScalar("executedEvents", events);
+        if (NOW > 0)
+            recordScalar("executedEventsPerSimSecond", events / NOW.dbl());
     }
 }
 
@@ -133,14 +193,6 @@ void LteBinder::unregisterNextHop(MacNodeId masterId, MacNodeId slaveId)
     nextHop_[slaveId] = 0;
 }
 
-OmnetId LteBinder::getOmnetId(MacNodeId nodeId)
-{
-    std::map<int, OmnetId>::iterator it = nodeIds_.find(nodeId);
-    if(it != nodeIds_.end())
-        return it->second;
-    return 0;
-}
-
 std::map<int, OmnetId>::const_iterator LteBinder::getNodeIdListBegin()
 {
     return nodeIds_.begin();
@@ -164,17 +216,53 @@ LteMacBase* LteBinder::getMacFromMacNodeId(MacNodeId id)
     if (id == 0)
         return NULL;
 
-    LteMacBase* mac;
-    if (macNodeIdToModule_.find(id) == macNodeIdToModule_.end())
-    {
-        mac = check_and_cast<LteMacBase*>(getMacByMacNodeId(id));
-        macNodeIdToModule_[id] = mac;
-    }
-    else
-    {
-        mac = macNodeIdToModule_[id];
-    }
-    return mac;
+    NodeEntry* entry = getNodeEntry(id);
+    if (entry == NULL)
+        throw cRuntimeError("LteBinder::getMacFromMacNodeId - node %d is not registered", id);
+
+    if (entry->mac == NULL)
+        entry->mac = check_and_cast<LteMacBase*>(getNicModule(entry)->getSubmodule("mac"));
+    return entry->mac;
+}
+
+cModule* LteBinder::getNicModule(NodeEntry* entry)
+{
+    if (entry->nic == NULL)
+        entry->nic = getSimulation()->getModule(entry->omnetId)->getSubmodule("lteNic");
+    return entry->nic;
+}
+
+LtePhyBase* LteBinder::getPhyByMacNodeId(MacNodeId id)
+{
+    NodeEntry* entry = getNodeEntry(id);
+    if (entry == NULL)
+        return NULL;
+
+    if (entry->phy == NULL)
+        entry->phy = check_and_cast<LtePhyBase*>(getNicModule(entry)->getSubmodule("phy"));
+    return entry->phy;
+}
+
+cModule* LteBinder::getRlcByMacNodeId(MacNodeId id, LteRlcType rlcType)
+{
+    NodeEntry* entry = getNodeEntry(id);
+    if (entry == NULL || rlcType == UNKNOWN_RLC_TYPE)
+        return NULL;
+
+    if (entry->rlc[rlcType] == NULL)
+        entry->rlc[rlcType] = getNicModule(entry)->getSubmodule("rlc")->getSubmodule(rlcTypeToA(rlcType).c_str());
+    return entry->rlc[rlcType];
+}
+
+LtePdcpRrcBase* LteBinder::getPdcpByMacNodeId(MacNodeId id)
+{
+    NodeEntry* entry = getNodeEntry(id);
+    if (entry == NULL)
+        return NULL;
+
+    if (entry->pdcp == NULL)
+        entry->pdcp = check_and_cast<LtePdcpRrcBase*>(getNicModule(entry)->getSubmodule("pdcpRrc"));
+    return entry->pdcp;
 }
 
 MacNodeId LteBinder::getNextHop(MacNodeId slaveId)
@@ -212,28 +300,38 @@ simtime_t LteBinder::getLastUpdateUlTransmissionInfo()
 
 void LteBinder::initAndResetUlTransmissionInfo()
 {
-    ulTransmissionMap_[PREV_TTI] = ulTransmissionMap_[1];
-    ulTransmissionMap_[CURR_TTI].clear();
-    ulTransmissionMap_[CURR_TTI].resize(numBands_);
+    // the current TTI becomes the previous one, and the storage of the latter is reused
+    ulTransmissionMap_[PREV_TTI].swap(ulTransmissionMap_[CURR_TTI]);
+    ulTransmissionCell_[PREV_TTI].swap(ulTransmissionCell_[CURR_TTI]);
+
+    std::vector< std::vector<UeAllocationInfo> >& currMap = ulTransmissionMap_[CURR_TTI];
+    currMap.resize(numBands_);
+    for (unsigned int b = 0; b < numBands_; b++)
+        currMap[b].clear();
+    ulTransmissionCell_[CURR_TTI].assign(numBands_, 0);
 
     lastUpdateUplinkTransmissionInfo_ = NOW;
 }
 
-void LteBinder::storeUlTransmissionMap(Remote antenna, RbMap& rbMap, MacNodeId nodeId, MacCellId cellId, LtePhyBase* phy, Direction dir)
+void LteBinder::storeUlTransmissionMap(Remote antenna, const RbMap& rbMap, MacNodeId nodeId, MacCellId cellId, LtePhyBase* phy, Direction dir)
 {
     UeAllocationInfo info;
     info.nodeId = nodeId;
     info.cellId = cellId;
     info.phy = phy;
     info.dir = dir;
+    info.txPower = phy->getTxPwr(dir);
 
     // for each allocated band, store the UE info
-    std::map<Band, unsigned int>::iterator it = rbMap[antenna].begin(), et = rbMap[antenna].end();
-    for ( ; it != et; ++it)
+    for (Band b = 0; b < rbMap.getNumBands(); ++b)
     {
-        Band b = it->first;
-        if (it->second > 0)
-            ulTransmissionMap_[CURR_TTI][b].push_back(info);
+        if (rbMap.get(antenna, b) > 0)
+        {
+            std::vector<UeAllocationInfo>& ues = ulTransmissionMap_[CURR_TTI][b];
+            MacCellId& bandCell = ulTransmissionCell_[CURR_TTI][b];
+            bandCell = (ues.empty() || bandCell == cellId) ? cellId : 0;
+            ues.push_back(info);
+        }
     }
 }
 
@@ -242,6 +340,39 @@ const std::vector<UeAllocationInfo>* LteBinder::getUlTransmissionMap(UlTransmiss
     return &(ulTransmissionMap_[t][b]);
 }
 
+MacCellId LteBinder::getUlTransmissionCell(UlTransmissionMapTTI t, Band b)
+{
+    if (b >= ulTransmissionCell_[t].size())
+        return 0;
+    return ulTransmissionCell_[t][b];
+}
+
+void LteBinder::updateNodePosition(MacNodeId nodeId, const Coord& position)
+{
+    if (getNodeTypeById(nodeId) == ENODEB)
+        enbPositions_.update(nodeId, position);
+    else
+        uePositions_.update(nodeId, position);
+}
+
+void LteBinder::removeNodePosition(MacNodeId nodeId)
+{
+    if (getNodeTypeById(nodeId) == ENODEB)
+        enbPositions_.remove(nodeId);
+    else
+        uePositions_.remove(nodeId);
+}
+
+void LteBinder::getEnbsInRange(const Coord& center, double range, std::vector<MacNodeId>& result)
+{
+    enbPositions_.query(center, range, result);
+}
+
+void LteBinder::getUesInRange(const Coord& center, double range, std::vector<MacNodeId>& result)
+{
+    uePositions_.query(center, range, result);
+}
+
 void LteBinder::registerX2Port(X2NodeId nodeId, int port)
 {
     if (x2ListeningPorts_.find(nodeId) == x2ListeningPorts_.end() )
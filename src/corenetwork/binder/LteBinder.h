@@ -18,8 +18,15 @@
 
 #include "common/LteCommon.h"
 #include "corenetwork/binder/PhyPisaData.h"
+#include "corenetwork/binder/LteSpatialIndex.h"
+#include "corenetwork/binder/LteTtiClock.h"
 #include "corenetwork/nodes/ExtCell.h"
 #include "stack/mac/layer/LteMacBase.h"
+#include "stack/mac/scheduler/LteTtiCoordinator.h"
+#include "stack/phy/ChannelModel/ExtCellInterferenceMap.h"
+
+class LtePhyBase;
+class LtePdcpRrcBase;
 
 /**
  * The LTE Binder module has one instance in the whole network.
@@ -46,19 +53,83 @@ class LteBinder : public omnetpp::cSimpleModule
     unsigned int numBands_;  // number of logical bands
     std::map<inet::Ipv4Address, MacNodeId> macNodeIdToIPAddress_;
     std::map<MacNodeId, char*> macNodeIdToModuleName_;
-    std::map<MacNodeId, LteMacBase*> macNodeIdToModule_;
     std::vector<MacNodeId> nextHop_; // MacNodeIdMaster --> MacNodeIdSlave
+
+    // registered nodes, sorted by MacNodeId. Only used to iterate over nodes:
+    // lookups by MacNodeId are served by the nodeRegistry_
     std::map<int, OmnetId> nodeIds_;
 
+    /*
+     * Flat node registry, directly indexed by MacNodeId
+     */
+    struct NodeEntry
+    {
+        OmnetId omnetId;    // 0 if the node is not registered
+        LteNodeType type;
+
+        // handles of the protocol layers, resolved on first access
+        omnetpp::cModule* nic;
+        LteMacBase* mac;
+        LtePhyBase* phy;
+        LtePdcpRrcBase* pdcp;
+        omnetpp::cModule* rlc[UNKNOWN_RLC_TYPE];
+
+        NodeEntry() : omnetId(0), type(UNKNOWN_NODE_TYPE), nic(NULL), mac(NULL), phy(NULL), pdcp(NULL)
+        {
+            for (int i = 0; i < UNKNOWN_RLC_TYPE; i++)
+                rlc[i] = NULL;
+        }
+    };
+    std::vector<NodeEntry> nodeRegistry_;
+
+    // returns the registry entry of a registered node, NULL otherwise
+    NodeEntry* getNodeEntry(MacNodeId nodeId)
+    {
+        if (nodeId >= nodeRegistry_.size() || nodeRegistry_[nodeId].omnetId == 0)
+            return NULL;
+        return &nodeRegistry_[nodeId];
+    }
+
+    // returns the lteNic module of a registered node
+    omnetpp::cModule* getNicModule(NodeEntry* entry);
+
     // list of static external cells. Used for intercell interference evaluation
     ExtCellList extCellList_;
 
+    // interference of the external cells, shared by all the channel models (if enabled)
+    ExtCellInterferenceMap extCellInterferenceMap_;
+
     // list of all eNBs. Used for inter-cell interference evaluation
     std::vector<EnbInfo*> enbList_;
 
     // list of all UEs. Used for inter-cell interference evaluation
     std::vector<UeInfo*> ueList_;
 
+    // eNB infos indexed by MacNodeId
+    std::vector<EnbInfo*> enbInfoById_;
+
+    /*
+     * Spatial index support
+     */
+    // positions of eNBs and UEs, updated by their PHY layer
+    LteSpatialIndex enbPositions_;
+    LteSpatialIndex uePositions_;
+
+    // interferers farther than this distance are not considered (negative means no cutoff)
+    double interferenceCutoffDistance_;
+
+    // if true, the scheduling passes of all the eNBs are grouped per TTI by the coordinator
+    bool coordinatedScheduling_;
+    LteTtiCoordinator ttiCoordinator_;
+
+    // if true, the per-TTI activities of MAC layers and feedback generators are run by the clock
+    bool globalTtiClock_;
+    LteTtiClock ttiClock_;
+    omnetpp::cMessage* ttiClockTick_;
+
+    // if true, the number of executed events per simulated second is recorded
+    bool recordEventRate_;
+
     MacNodeId macNodeIdCounter_[3]; // MacNodeId Counter
     DeployedUesMap dMap_; // DeployedUes --> Master Mapping
 
@@ -67,7 +138,10 @@ class LteBinder : public omnetpp::cSimpleModule
      */
     typedef std::vector< std::vector< std::vector<UeAllocationInfo> > > UplinkTransmissionMap;
     // for both previous and current TTIs, for each RB, stores the UE (nodeId and ref to the PHY module) that transmitted/are transmitting within that RB
+    // The two TTIs are swapped at each TTI, so that the vectors of each RB keep their storage
     UplinkTransmissionMap ulTransmissionMap_;
+    // for both previous and current TTIs, for each RB, the cell of all the UEs in ulTransmissionMap_, 0 if they belong to different cells
+    std::vector< std::vector<MacCellId> > ulTransmissionCell_;
     // TTI of the last update of the UL band status
     omnetpp::simtime_t lastUpdateUplinkTransmissionInfo_;
 
@@ -103,9 +177,9 @@ class LteBinder : public omnetpp::cSimpleModule
 
     virtual int numInitStages() const override { return inet::INITSTAGE_LAST; }
 
-    virtual void handleMessage(omnetpp::cMessage *msg) override
-    {
-    }
+    virtual void handleMessage(omnetpp::cMessage *msg) override;
+
+    virtual void finish() override;
 
   public:
     LteBinder()
@@ -115,6 +189,11 @@ class LteBinder : public omnetpp::cSimpleModule
         macNodeIdCounter_[2] = UE_MIN_ID;
 
         ulTransmissionMap_.resize(2); // store transmission map of previous and current TTI
+        ulTransmissionCell_.resize(2);
+
+        globalTtiClock_ = false;
+        recordEventRate_ = false;
+        ttiClockTick_ = NULL;
     }
 
     unsigned int getNumBands()
@@ -124,6 +203,7 @@ class LteBinder : public omnetpp::cSimpleModule
 
     virtual ~LteBinder()
     {
+        cancelAndDelete(ttiClockTick_);
         while(enbList_.size() > 0){
             delete enbList_.back();
             enbList_.pop_back();
@@ -180,7 +260,19 @@ class LteBinder : public omnetpp::cSimpleModule
      * @param nodeId MacNodeId of the module
      * @return OmnetId of the module
      */
-    OmnetId getOmnetId(MacNodeId nodeId);
+    OmnetId getOmnetId(MacNodeId nodeId)
+    {
+        return (nodeId < nodeRegistry_.size()) ? nodeRegistry_[nodeId].omnetId : 0;
+    }
+
+    /**
+     * getNodeType() returns the type the node has been registered with,
+     * UNKNOWN_NODE_TYPE if it is not registered
+     */
+    LteNodeType getNodeType(MacNodeId nodeId)
+    {
+        return (nodeId < nodeRegistry_.size()) ? nodeRegistry_[nodeId].type : UNKNOWN_NODE_TYPE;
+    }
 
     /*
      * get iterators for the list of nodes
@@ -206,6 +298,14 @@ class LteBinder : public omnetpp::cSimpleModule
      */
     LteMacBase* getMacFromMacNodeId(MacNodeId id);
 
+    /*
+     * Cached handles of the protocol layers of a node, given its MacNodeId.
+     * They return NULL if the node is not registered (e.g. it has left the simulation)
+     */
+    LtePhyBase* getPhyByMacNodeId(MacNodeId id);
+    omnetpp::cModule* getRlcByMacNodeId(MacNodeId id, LteRlcType rlcType);
+    LtePdcpRrcBase* getPdcpByMacNodeId(MacNodeId id);
+
     /**
      * getNextHop() returns the master of
      * a given slave
@@ -292,14 +392,32 @@ class LteBinder : public omnetpp::cSimpleModule
         return extCellList_.size() - 1;
     }
 
-    ExtCellList getExtCellList()
+    const ExtCellList& getExtCellList()
     {
         return extCellList_;
     }
 
+    /*
+     * External cells interference map support.
+     * Parameters are read directly, as external cells may be initialized before the binder
+     */
+    bool isExtCellInterferenceMap() { return par("extCellInterferenceMap").boolValue(); }
+    double getExtCellInterferenceMapResolution() { return par("extCellInterferenceMapResolution").doubleValue(); }
+    ExtCellInterferenceMap* getExtCellInterferenceMap() { return &extCellInterferenceMap_; }
+
     void addEnbInfo(EnbInfo* info)
     {
         enbList_.push_back(info);
+        if (enbInfoById_.size() <= info->id)
+            enbInfoById_.resize(info->id + 1, NULL);
+        enbInfoById_[info->id] = info;
+    }
+
+    EnbInfo* getEnbInfo(MacNodeId id)
+    {
+        if (id >= enbInfoById_.size())
+            return NULL;
+        return enbInfoById_[id];
     }
 
     std::vector<EnbInfo*> * getEnbList()
@@ -319,13 +437,46 @@ class LteBinder : public omnetpp::cSimpleModule
 
     Cqi meanCqi(std::vector<Cqi> bandCqi,MacNodeId id,Direction dir);
 
+    /*
+     * Spatial index support
+     */
+    // update the position of the given node. Called by the PHY layer upon mobility updates
+    void updateNodePosition(MacNodeId nodeId, const inet::Coord& position);
+    // remove the node from the spatial index
+    void removeNodePosition(MacNodeId nodeId);
+    // returns true if a cutoff distance for interference computation is configured
+    bool hasInterferenceCutoff() { return interferenceCutoffDistance_ >= 0; }
+    double getInterferenceCutoffDistance() { return interferenceCutoffDistance_; }
+    // get the eNBs (or UEs) within the given distance from the given point
+    void getEnbsInRange(const inet::Coord& center, double range, std::vector<MacNodeId>& result);
+    void getUesInRange(const inet::Coord& center, double range, std::vector<MacNodeId>& result);
+    // number of UEs (and relays) whose position is known
+    unsigned int getNumUePositions() { return uePositions_.size(); }
+
+    /*
+     * Coordinated scheduling support
+     */
+    bool isCoordinatedScheduling() { return coordinatedScheduling_; }
+    LteTtiCoordinator* getTtiCoordinator() { return &ttiCoordinator_; }
+
+    /*
+     * Global TTI clock support
+     */
+    bool isGlobalTtiClock() { return globalTtiClock_; }
+    LteTtiClock* getTtiClock() { return &ttiClock_; }
+
     /*
      * Uplink interference support
      */
     omnetpp::simtime_t getLastUpdateUlTransmissionInfo();
     void initAndResetUlTransmissionInfo();
-    void storeUlTransmissionMap(Remote antenna, RbMap& rbMap, MacNodeId nodeId, MacCellId cellId, LtePhyBase* phy, Direction dir);
+    void storeUlTransmissionMap(Remote antenna, const RbMap& rbMap, MacNodeId nodeId, MacCellId cellId, LtePhyBase* phy, Direction dir);
     const std::vector<UeAllocationInfo>* getUlTransmissionMap(UlTransmissionMapTTI t, Band b);
+    /*
+     * Returns the cell of all the UEs transmitting in the given RB, 0 if they belong to different cells
+     * (or there is no UE), so that receivers ignoring their own cell can skip the RB at once
+     */
+    MacCellId getUlTransmissionCell(UlTransmissionMapTTI t, Band b);
     /*
      * X2 Support
      */
@@ -0,0 +1,151 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "corenetwork/binder/LteSpatialIndex.h"
+
+using namespace omnetpp;
+using namespace inet;
+
+LteSpatialIndex::LteSpatialIndex(double cellSize)
+{
+    setCellSize(cellSize);
+}
+
+void LteSpatialIndex::setCellSize(double cellSize)
+{
+    if (cellSize <= 0)
+        throw cRuntimeError("LteSpatialIndex::setCellSize - cell size must be positive (%f)", cellSize);
+
+    cellSize_ = cellSize;
+
+    // re-insert nodes according to the new grid
+    cells_.clear();
+    std::map<MacNodeId, NodeEntry>::iterator it = nodes_.begin();
+    for (; it != nodes_.end(); ++it)
+    {
+        it->second.cell = toCell(it->second.position);
+        cells_[it->second.cell].push_back(it->first);
+    }
+}
+
+LteSpatialIndex::CellKey LteSpatialIndex::toCell(const Coord& pos) const
+{
+    // clamp to avoid overflows with very large query ranges
+    const double maxIndex = std::numeric_limits<int>::max() / 2;
+    double x = std::max(-maxIndex, std::min(maxIndex, floor(pos.x / cellSize_)));
+    double y = std::max(-maxIndex, std::min(maxIndex, floor(pos.y / cellSize_)));
+    return CellKey((int)x, (int)y);
+}
+
+void LteSpatialIndex::removeFromCell(MacNodeId id, const CellKey& cell)
+{
+    std::map<CellKey, std::vector<MacNodeId> >::iterator ct = cells_.find(cell);
+    if (ct == cells_.end())
+        return;
+
+    std::vector<MacNodeId>& ids = ct->second;
+    std::vector<MacNodeId>::iterator it = std::find(ids.begin(), ids.end(), id);
+    if (it != ids.end())
+    {
+        // order within a cell is not relevant
+        *it = ids.back();
+        ids.pop_back();
+    }
+    if (ids.empty())
+        cells_.erase(ct);
+}
+
+void LteSpatialIndex::update(MacNodeId id, const Coord& pos)
+{
+    CellKey cell = toCell(pos);
+
+    std::map<MacNodeId, NodeEntry>::iterator it = nodes_.find(id);
+    if (it == nodes_.end())
+    {
+        NodeEntry entry;
+        entry.position = pos;
+        entry.cell = cell;
+        nodes_[id] = entry;
+        cells_[cell].push_back(id);
+        return;
+    }
+
+    it->second.position = pos;
+    if (it->second.cell != cell)
+    {
+        removeFromCell(id, it->second.cell);
+        it->second.cell = cell;
+        cells_[cell].push_back(id);
+    }
+}
+
+void LteSpatialIndex::remove(MacNodeId id)
+{
+    std::map<MacNodeId, NodeEntry>::iterator it = nodes_.find(id);
+    if (it == nodes_.end())
+        return;
+
+    removeFromCell(id, it->second.cell);
+    nodes_.erase(it);
+}
+
+const Coord& LteSpatialIndex::getPosition(MacNodeId id) const
+{
+    std::map<MacNodeId, NodeEntry>::const_iterator it = nodes_.find(id);
+    if (it == nodes_.end())
+        throw cRuntimeError("LteSpatialIndex::getPosition - node %d not found", id);
+    return it->second.position;
+}
+
+void LteSpatialIndex::query(const Coord& center, double radius, std::vector<MacNodeId>& result) const
+{
+    if (radius < 0)
+        return;
+
+    CellKey minCell = toCell(Coord(center.x - radius, center.y - radius));
+    CellKey maxCell = toCell(Coord(center.x + radius, center.y + radius));
+    double numVisitedCells = ((double)maxCell.first - minCell.first + 1) * ((double)maxCell.second - minCell.second + 1);
+
+    std::map<CellKey, std::vector<MacNodeId> >::const_iterator ct;
+    if (numVisitedCells > cells_.size())
+    {
+        // the circle covers more cells than the occupied ones, visit the latter only
+        for (ct = cells_.begin(); ct != cells_.end(); ++ct)
+        {
+            if (ct->first.first < minCell.first || ct->first.first > maxCell.first ||
+                ct->first.second < minCell.second || ct->first.second > maxCell.second)
+                continue;
+
+            std::vector<MacNodeId>::const_iterator it = ct->second.begin();
+            for (; it != ct->second.end(); ++it)
+                if (nodes_.at(*it).position.distance(center) <= radius)
+                    result.push_back(*it);
+        }
+        return;
+    }
+
+    for (int x = minCell.first; x <= maxCell.first; x++)
+    {
+        for (int y = minCell.second; y <= maxCell.second; y++)
+        {
+            ct = cells_.find(CellKey(x, y));
+            if (ct == cells_.end())
+                continue;
+
+            std::vector<MacNodeId>::const_iterator it = ct->second.begin();
+            for (; it != ct->second.end(); ++it)
+                if (nodes_.at(*it).position.distance(center) <= radius)
+                    result.push_back(*it);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTESPATIALINDEX_H_
+#define _LTE_LTESPATIALINDEX_H_
+
+#include <map>
+#include <vector>
+
+#include <inet/common/geometry/common/Coord.h>
+
+#include "common/LteCommon.h"
+
+/**
+ * Uniform grid of node positions on the x-y plane.
+ *
+ * Each node is stored in the square cell containing its position, so that
+ * the nodes within a given distance from a point can be retrieved by
+ * visiting the cells overlapping the circle only.
+ * Positions are kept up to date by the LteBinder, which is notified
+ * by the PHY layers whenever their mobility module moves the node.
+ */
+class LteSpatialIndex
+{
+    typedef std::pair<int, int> CellKey;
+
+    struct NodeEntry
+    {
+        inet::Coord position;
+        CellKey cell;
+    };
+
+    // side of a grid cell (m)
+    double cellSize_;
+
+    // nodes in each non-empty cell
+    std::map<CellKey, std::vector<MacNodeId> > cells_;
+
+    // last known position of each node
+    std::map<MacNodeId, NodeEntry> nodes_;
+
+    CellKey toCell(const inet::Coord& pos) const;
+
+    void removeFromCell(MacNodeId id, const CellKey& cell);
+
+  public:
+    LteSpatialIndex(double cellSize = 500.0);
+
+    void setCellSize(double cellSize);
+
+    /**
+     * Inserts the node, or moves it to the given position
+     */
+    void update(MacNodeId id, const inet::Coord& pos);
+
+    /**
+     * Removes the node from the index
+     */
+    void remove(MacNodeId id);
+
+    /**
+     * Returns true if the position of the node is known
+     */
+    bool contains(MacNodeId id) const { return nodes_.find(id) != nodes_.end(); }
+
+    /**
+     * Returns the last known position of the node
+     */
+    const inet::Coord& getPosition(MacNodeId id) const;
+
+    /**
+     * Appends to the result vector the nodes whose distance from center is
+     * not greater than radius
+     *
+     * @param center point of the query
+     * @param radius maximum distance (m)
+     * @param result[output] ids of the nodes within range
+     */
+    void query(const inet::Coord& center, double radius, std::vector<MacNodeId>& result) const;
+
+    unsigned int size() const { return nodes_.size(); }
+};
+
+#endif
@@ -0,0 +1,45 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "corenetwork/binder/LteTtiClock.h"
+
+using namespace omnetpp;
+
+LteTtiClock::LteTtiClock()
+{
+    ticks_ = 0;
+    dispatchedTtis_ = 0;
+}
+
+void LteTtiClock::registerClient(Phase phase, MacNodeId nodeId, LteTtiClient* client)
+{
+    ClientKey key(phase, nodeId);
+    if (clients_.find(key) != clients_.end())
+        throw cRuntimeError("LteTtiClock::registerClient - node %d already registered in phase %d", nodeId, phase);
+
+    clients_[key] = client;
+}
+
+void LteTtiClock::unregisterClients(MacNodeId nodeId)
+{
+    clients_.erase(ClientKey(FEEDBACK_PHASE, nodeId));
+    clients_.erase(ClientKey(MAC_PHASE, nodeId));
+}
+
+void LteTtiClock::tick()
+{
+    ticks_++;
+
+    std::map<ClientKey, LteTtiClient*>::iterator it = clients_.begin();
+    for (; it != clients_.end(); ++it)
+    {
+        it->second->handleTti();
+        dispatchedTtis_++;
+    }
+}
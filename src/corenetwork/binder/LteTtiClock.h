@@ -0,0 +1,87 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTETTICLOCK_H_
+#define _LTE_LTETTICLOCK_H_
+
+#include <map>
+
+#include "common/LteCommon.h"
+
+/**
+ * Interface of the entities driven by the LteTtiClock
+ */
+class LteTtiClient
+{
+  public:
+    virtual ~LteTtiClient() {}
+
+    /**
+     * Called once per TTI by the clock. Implementations must switch
+     * to their own module context (e.g. with Enter_Method_Silent)
+     */
+    virtual void handleTti() = 0;
+};
+
+/**
+ * @class LteTtiClock
+ *
+ * Global TTI clock.
+ *
+ * When the global TTI clock is enabled in the LteBinder, the MAC layers and
+ * the DL feedback generators do not schedule their own per-TTI self messages.
+ * Instead, they register here and the binder runs all of them with a single
+ * event per TTI.
+ * Clients are visited phase by phase, in increasing node id order within
+ * each phase, so that the outcome does not depend on the initialization order.
+ * Feedback generators come first, as their timers used to run before the
+ * TTI ticks of the MAC layers.
+ */
+class LteTtiClock
+{
+  public:
+    enum Phase
+    {
+        FEEDBACK_PHASE = 0, MAC_PHASE
+    };
+
+  private:
+    typedef std::pair<Phase, MacNodeId> ClientKey;
+
+    // registered clients, sorted by phase and node id
+    std::map<ClientKey, LteTtiClient*> clients_;
+
+    // number of TTIs run so far
+    unsigned long ticks_;
+
+    // number of calls to the clients so far
+    unsigned long dispatchedTtis_;
+
+  public:
+    LteTtiClock();
+
+    void registerClient(Phase phase, MacNodeId nodeId, LteTtiClient* client);
+
+    /**
+     * Removes all the clients of the given node.
+     * Must not be called from within tick()
+     */
+    void unregisterClients(MacNodeId nodeId);
+
+    /**
+     * Calls handleTti() on all the registered clients
+     */
+    void tick();
+
+    unsigned int size() const { return clients_.size(); }
+    unsigned long getTicks() const { return ticks_; }
+    unsigned long getDispatchedTtis() const { return dispatchedTtis_; }
+};
+
+#endif
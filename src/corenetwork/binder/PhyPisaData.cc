@@ -2649,6 +2649,13 @@ PhyPisaData::PhyPisaData()
     // TODO Auto-generated constructor stub
     memcpy(blerCurves_, blerCurvesNew, sizeof(double) * 3 * 15 * 49);
     memcpy(lambdaTable_, lambdaTable, sizeof(double) * 10000 * 3);
+
+    // precompute the success probabilities used for the error decision of each frame
+    for (int i = 0; i < nTxMode(); i++)
+        for (int j = 0; j < nMcs(); j++)
+            for (int k = 0; k <= maxSnr(); k++)
+                successProbability_[i][j][k] = 1 - getBler(i, j, k);
+
     channel_.resize(10000);
     double x, y;
     for (int i = 0; i < 1000; i++)
@@ -19,11 +19,14 @@ class PhyPisaData
 {
     double lambdaTable_[10000][3];
     double blerCurves_[3][15][49];
+    // success probability (1 - bler) for each txmode, mcs and snr in [0, maxSnr()]
+    double successProbability_[3][15][50];
     std::vector<double> channel_;
     public:
     PhyPisaData();
     virtual ~PhyPisaData();
     double getBler(int i, int j, int k){if (j==0) return 1; else return blerCurves_[i][j][k-1];}
+    double getSuccessProbability(int i, int j, int k){return successProbability_[i][j][k];}
     double getLambda(int i, int j){return lambdaTable_[i][j];}
     int nTxMode(){return 3;}
     int nMcs(){return 15;}
@@ -84,14 +84,20 @@ void ExtCell::initialize()
         }
 
         // TODO: if extCell-interference is disabled, do not send selfMessages
-        /* Start TTI tick */
-        ttiTick_ = new cMessage("ttiTick_");
-        ttiTick_->setSchedulingPriority(1);        // TTI TICK after other messages
-        scheduleAt(NOW + TTI, ttiTick_);
+        // with the interference map, channel models only use the average band occupation
+        if (!binder_->isExtCellInterferenceMap())
+        {
+            /* Start TTI tick */
+            ttiTick_ = new cMessage("ttiTick_");
+            ttiTick_->setSchedulingPriority(1);        // TTI TICK after other messages
+            scheduleAt(NOW + TTI, ttiTick_);
+        }
     }
 
     // add this cell to the binder
     id_ = binder_->addExtCell(this);
+
+    computeBandLoad();
 }
 
 void ExtCell::handleMessage(cMessage *msg)
@@ -149,6 +155,31 @@ void ExtCell::resetBandStatus()
     bandStatus_.resize(numBands_, 0);
 }
 
+void ExtCell::computeBandLoad()
+{
+    if (allocationType_ == RANDOM_ALLOC)
+    {
+        // each band is allocated with probability equal to bandUtilization_
+        bandLoad_.assign(numBands_, bandUtilization_);
+        return;
+    }
+
+    if (allocationType_ == CONTIGUOUS_ALLOC)
+    {
+        // the contiguous allocation is the same at every TTI: compute it once
+        // and restore the initial status
+        BandStatus status = bandStatus_;
+        BandStatus prevStatus = prevBandStatus_;
+        updateBandStatus();
+        bandLoad_.assign(bandStatus_.begin(), bandStatus_.end());
+        bandStatus_ = status;
+        prevBandStatus_ = prevStatus;
+        return;
+    }
+
+    bandLoad_.assign(numBands_, 1.0);
+}
+
 void ExtCell::setBandUtilization(double bandUtilization)
 {
     if (bandUtilization < 0)
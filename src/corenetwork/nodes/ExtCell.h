@@ -52,6 +52,9 @@ class ExtCell : public omnetpp::cSimpleModule
     BandStatus bandStatus_;
     BandStatus prevBandStatus_;
 
+    // Average occupation of each band. Used by the interference map of the channel models
+    std::vector<double> bandLoad_;
+
     // TTI self message
     omnetpp::cMessage* ttiTick_;
 
@@ -72,6 +75,9 @@ class ExtCell : public omnetpp::cSimpleModule
 
     // move the current status in the prevBandStatus structure and reset the former
     void resetBandStatus();
+
+    // compute the average occupation of each band for the given allocation type
+    void computeBandLoad();
     /*****************************/
 
   protected:
@@ -98,6 +104,12 @@ class ExtCell : public omnetpp::cSimpleModule
 
     int getPrevBandStatus(int band) { return prevBandStatus_.at(band); }
 
+    /*
+     * Average occupation of the band, between 0 and 1: the band utilization for
+     * RANDOM_ALLOC, the (fixed) band status for the other allocation types
+     */
+    double getBandLoad(int band) { return bandLoad_.at(band); }
+
     // set the band utilization percentage
     void setBandUtilization(double bandUtilization);
 };
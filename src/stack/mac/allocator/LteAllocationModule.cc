@@ -39,23 +39,15 @@ void LteAllocationModule::initAndReset(const unsigned int resourceBlocks, const
     // set the available antennas of MAIN plane to 1 (just MACRO antenna)
     allocatedRbsMatrix_.at(MAIN_PLANE).resize(MACRO + 1, 0);
 
-    // clean and copy stored block-allocation info
-    prevAllocatedRbsPerBand_.clear();
-    prevAllocatedRbsPerBand_ = allocatedRbsPerBand_;
+    // store the block-allocation info of the last TTI, the storage of the older one is reused below
+    prevBandOccupancy_.swap(bandOccupancy_);
 
-    // clear and reinitialize the allocatedBlocks structures and set available planes to 1 (just the main OFDMA space)
-    allocatedRbsPerBand_.clear();
-    allocatedRbsPerBand_.resize(MAIN_PLANE + 1);
+    // reinitialize the band occupancy and set available planes to 1 (just the main OFDMA space)
+    bandOccupancy_.resize(MAIN_PLANE + 1);
     // set the available antennas of MAIN plane to 1 (just MACRO antenna)
-    allocatedRbsPerBand_.at(MAIN_PLANE).resize(MACRO + 1);
-
-    // clear and reinitialize the freeResourceBlocks vector and set available planes to 1 (just the main OFDMA space)
-    freeRbsMatrix_.clear();
-    freeRbsMatrix_.resize(MAIN_PLANE + 1);
-    // set the available antennas of MAIN plane to 1 (just MACRO antenna)
-    freeRbsMatrix_.at(MAIN_PLANE).resize(MACRO + 1);
-    // initializes all free blocks for each band in the main plane, MACRO antenna.
-    freeRbsMatrix_.at(MAIN_PLANE).at(MACRO).resize(bands_, 0);
+    bandOccupancy_.at(MAIN_PLANE).resize(MACRO + 1);
+    // all the bands of the main plane, MACRO antenna, are free
+    bandOccupancy_.at(MAIN_PLANE).at(MACRO).reset(bands_);
 
     // clear UE,LB Map
     allocatedRbsUe_.clear();
@@ -73,12 +65,8 @@ void LteAllocationModule::configureOFDMplane(const Plane plane)
         allocatedRbsMatrix_.resize(plane + 1);
         allocatedRbsMatrix_.at(plane).resize(MACRO + 1);
 
-        allocatedRbsPerBand_.resize(plane + 1);
-        allocatedRbsPerBand_.at(plane).resize(MACRO + 1);
-
-        freeRbsMatrix_.resize(plane + 1);
-        freeRbsMatrix_.at(plane).resize(MACRO + 1);
-        freeRbsMatrix_.at(plane).at(MACRO).resize(bands_, 0);
+        bandOccupancy_.resize(plane + 1);
+        resizeBandOccupancy(plane, MACRO + 1);
 
         // we set newly created OFDMA space equal to its peer space
         totalRbsMatrix_[plane][MACRO] = totalRbsMatrix_[MAIN_PLANE][MACRO];
@@ -96,14 +84,34 @@ void LteAllocationModule::setRemoteAntenna(const Plane plane, const Remote anten
         // here we have to add missing antennas to the given plane and to set the number of RB for each antenna in this plane
         totalRbsMatrix_.at(plane).resize(i + 1);
         allocatedRbsMatrix_.at(plane).resize(i + 1);
-        allocatedRbsPerBand_.at(plane).resize(i + 1);
-        freeRbsMatrix_.at(plane).resize(i + 1);
-        freeRbsMatrix_.at(plane).at(i).resize(bands_, 0);
+        resizeBandOccupancy(plane, i + 1);
         // initialize new antenna space with macro space
         totalRbsMatrix_[plane][i] = totalRbsMatrix_[plane][MACRO];
     }
 }
 
+void LteAllocationModule::resizeBandOccupancy(const Plane plane, const unsigned int antennas)
+{
+    std::vector<BandOccupancy>& occupancy = bandOccupancy_.at(plane);
+    unsigned int size = occupancy.size();
+    occupancy.resize(antennas);
+    // all the bands of the new spaces are free
+    for (unsigned int i = size; i < antennas; ++i)
+        occupancy[i].reset(bands_);
+}
+
+void LteAllocationModule::resizeUeTables(AllocatedRbsPerUeInfo& info, const Remote antenna)
+{
+    if (info.antennaAllocatedRbs_.size() > (unsigned int) antenna)
+        return;
+
+    unsigned int size = (antenna + 1) * bands_;
+    info.ueAllocatedRbs_.resize(size, 0);
+    info.ueAllocatedBytes_.resize(size, 0);
+    info.allocationList_.resize(size);
+    info.antennaAllocatedRbs_.resize(antenna + 1, 0);
+}
+
 bool LteAllocationModule::configureMuMimoPeering(const MacNodeId nodeId, const MacNodeId peer)
 {
     //---------- Peering availability Check ----------
@@ -196,7 +204,7 @@ unsigned int LteAllocationModule::availableBlocks(const MacNodeId nodeId, const
 
     unsigned int blocksPerBand = (totalRbsMatrix_[plane][antenna]) / bands_;
     // blocks allocated in the current band
-    unsigned int allocatedBlocks = allocatedRbsPerBand_[plane][antenna][band].allocated_;
+    unsigned int allocatedBlocks = bandOccupancy_[plane][antenna].getBlocks(band);
 
     if (blocksPerBand >= allocatedBlocks)
     {
@@ -216,13 +224,13 @@ unsigned int LteAllocationModule::availableBlocks(const MacNodeId nodeId, const
 
 unsigned int LteAllocationModule::getAllocatedBlocks(Plane plane, const Remote antenna, const Band band)
 {
-    return allocatedRbsPerBand_[plane][antenna][band].allocated_;
+    return bandOccupancy_[plane][antenna].getBlocks(band);
 }
 
 unsigned int LteAllocationModule::getInterferringBlocks(Plane plane, const Remote antenna, const Band band)
 {
-    if (!prevAllocatedRbsPerBand_.empty())
-        return prevAllocatedRbsPerBand_[plane][antenna][band].allocated_;
+    if (!prevBandOccupancy_.empty())
+        return prevBandOccupancy_[plane][antenna].getBlocks(band);
     else
         return 1000;
 }
@@ -230,7 +238,7 @@ unsigned int LteAllocationModule::getInterferringBlocks(Plane plane, const Remot
 unsigned int LteAllocationModule::availableBlocks(const MacNodeId nodeId, const Plane plane, const Band band)
 {
     // compute available blocks on all antennas for given user and plane.
-    RemoteSet antennas = allocatedRbsUe_.at(nodeId).availableAntennaSet_;
+    const RemoteSet& antennas = allocatedRbsUe_.at(nodeId).availableAntennaSet_;
     RemoteSet::iterator it = antennas.begin(), et = antennas.end();
 
     unsigned int available = 0;
@@ -247,7 +255,7 @@ bool LteAllocationModule::addBlocks(const Band band, const MacNodeId nodeId, con
     const unsigned int bytes)
 {
     //  all antennas for given user and plane.
-    RemoteSet antennas = allocatedRbsUe_.at(nodeId).availableAntennaSet_;
+    const RemoteSet& antennas = allocatedRbsUe_.at(nodeId).availableAntennaSet_;
     RemoteSet::iterator it = antennas.begin(), et = antennas.end();
     bool ret = false;
     for (; it != et; ++it)
@@ -290,20 +298,23 @@ bool LteAllocationModule::addBlocks(const Remote antenna, const Band band, const
     }
 
         // Note the request on the allocator structures
-    allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[nodeId] += blocks;
-    allocatedRbsPerBand_[plane][antenna][band].ueAllocatedBytesMap_[nodeId] += bytes;
-    allocatedRbsPerBand_[plane][antenna][band].allocated_ += blocks;
-
-    allocatedRbsUe_[nodeId].ueAllocatedRbsMap_[antenna][band] += blocks;
-    allocatedRbsUe_[nodeId].allocatedBlocks_ += blocks;
-    allocatedRbsUe_[nodeId].allocatedBytes_ += bytes;
-    allocatedRbsUe_[nodeId].antennaAllocatedRbs_[antenna] += blocks;
+    BandOccupancy& occupancy = bandOccupancy_[plane][antenna];
+    occupancy.setBlocks(band, occupancy.getBlocks(band) + blocks);
+
+    AllocatedRbsPerUeInfo& info = allocatedRbsUe_[nodeId];
+    resizeUeTables(info, antenna);
+    unsigned int index = ueIndex(antenna, band);
+    info.ueAllocatedRbs_[index] += blocks;
+    info.ueAllocatedBytes_[index] += bytes;
+    info.allocatedBlocks_ += blocks;
+    info.allocatedBytes_ += bytes;
+    info.antennaAllocatedRbs_[antenna] += blocks;
 
     // Store the request in the allocationList
     AllocationElem elem;
     elem.resourceBlocks_ = blocks;
     elem.bytes_ = bytes;
-    allocatedRbsUe_[nodeId].allocationMap_[antenna][band].push_back(elem);
+    info.allocationList_[index].push_back(elem);
 
     // update the allocatedBlocks counter
     allocatedRbsMatrix_[plane][antenna] += blocks;
@@ -325,22 +336,24 @@ unsigned int LteAllocationModule::removeBlocks(const Remote antenna, const Band
     // retrieving user's plane
     Plane plane = getOFDMPlane(nodeId);
 
-    unsigned int toDrain = allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[nodeId];
+    AllocatedRbsPerUeInfo& info = allocatedRbsUe_[nodeId];
+    unsigned int index = ueIndex(antenna, band);
+    unsigned int toDrain = (index < info.ueAllocatedRbs_.size()) ? info.ueAllocatedRbs_[index] : 0;
 
     // If the number of blocks allocated by the nodeId in the band is zero, do nothing!
     if(toDrain == 0)
     return toDrain;
 
     // Note the removal on the allocator structures
-    allocatedRbsPerBand_[plane][antenna][band].allocated_ -= toDrain;
-    allocatedRbsUe_[nodeId].allocatedBlocks_-= toDrain;
+    BandOccupancy& occupancy = bandOccupancy_[plane][antenna];
+    occupancy.setBlocks(band, occupancy.getBlocks(band) - toDrain);
+    info.allocatedBlocks_-= toDrain;
 
-    allocatedRbsUe_[nodeId].ueAllocatedRbsMap_[antenna][band] = 0;
-    allocatedRbsUe_[nodeId].allocatedBytes_=0;
-    allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[nodeId] = 0;
+    info.ueAllocatedRbs_[index] = 0;
+    info.allocatedBytes_=0;
 
     // drop the allocation list
-    allocatedRbsUe_[nodeId].allocationMap_[antenna][band].clear();
+    info.allocationList_[index].clear();
 
     // update the allocatedBlocks counter
     allocatedRbsMatrix_[plane][antenna] -= toDrain;
@@ -355,7 +368,7 @@ unsigned int
 LteAllocationModule::rbOccupation(const MacNodeId nodeId, RbMap& rbMap)
 {
     // compute allocated blocks on all antennas for given user and logical band.
-    RemoteSet antennas = allocatedRbsUe_.at(nodeId).availableAntennaSet_;
+    const RemoteSet& antennas = allocatedRbsUe_.at(nodeId).availableAntennaSet_;
     RemoteSet::iterator it = antennas.begin(), et = antennas.end();
 
     unsigned int blocks = 0;
@@ -364,7 +377,9 @@ LteAllocationModule::rbOccupation(const MacNodeId nodeId, RbMap& rbMap)
     {
         for (Band b = 0; b < bands_; ++b)
         {
-            blocks += (rbMap[*it][b] = getBlocks(*it, b, nodeId));
+            unsigned int allocated = getBlocks(*it, b, nodeId);
+            rbMap.set(*it, b, allocated);
+            blocks += allocated;
         }
     }
     return blocks;
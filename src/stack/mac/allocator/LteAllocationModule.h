@@ -10,6 +10,8 @@
 #ifndef _LTE_LTEALLOCATIONMODULE_H_
 #define _LTE_LTEALLOCATIONMODULE_H_
 
+#include <bitset>
+
 #include "common/LteCommon.h"
 #include "stack/mac/allocator/LteAllocatorUtils.h"
 
@@ -55,13 +57,6 @@ class LteAllocationModule
      */
     std::vector<std::vector<unsigned int> > allocatedRbsMatrix_;
 
-    /**
-     * Amount of available resource blocks, for each plane, for each antenna and for each band
-     *
-     * e.g. availableRbsMatrix_[ <plane> ] [ <antenna> ] [ <band> ]
-     */
-    std::vector<std::vector<std::vector<unsigned int> > > freeRbsMatrix_;
-
     /************************************************************
      *    From UE to Logical Band
      ************************************************************/
@@ -78,10 +73,6 @@ class LteAllocationModule
 
     typedef std::list<AllocationElem> AllocationList;
 
-    typedef std::map<Band, AllocationList> PerBandAllocationMap;
-
-    typedef std::map<Band, unsigned int> PerBandAllocatedRbsMap;
-
     /// This structure contains information for a single UE
     struct AllocatedRbsPerUeInfo
     {
@@ -96,12 +87,14 @@ class LteAllocationModule
         bool secondaryUser_;
         MacNodeId peerId_;
 
-        // amount of blocks allocated for this UE for each remote and for each band
-        std::map<Remote, PerBandAllocatedRbsMap> ueAllocatedRbsMap_;
+        // amount of blocks and bytes allocated for this UE for each remote and for each band,
+        // indexed by remote * bands + band (see LteAllocationModule::ueIndex())
+        std::vector<unsigned int> ueAllocatedRbs_;
+        std::vector<unsigned int> ueAllocatedBytes_;
         /// When an allocation is performed, the amount of blocks requested and the amount of bytes is registered into this list
-        std::map<Remote, PerBandAllocationMap> allocationMap_;
+        std::vector<AllocationList> allocationList_;
         // amount of blocks allocated for this UE for each remote
-        std::map<Remote, unsigned int> antennaAllocatedRbs_;
+        std::vector<unsigned int> antennaAllocatedRbs_;
 
         // antennas available for this user
         RemoteSet availableAntennaSet_;
@@ -137,39 +130,76 @@ class LteAllocationModule
      ************************************************************/
   public:
 
-    typedef std::map<MacNodeId, unsigned int> UeAllocatedBlocksMap;
-    typedef std::map<MacNodeId, unsigned int> UeAllocatedBytesMap;
-
-    /// This structure contains information for a single band
-    struct AllocatedRbsPerBandInfo
+    /**
+     * Occupancy of the logical bands of one plane and antenna: amount of blocks
+     * allocated in each band, plus a packed bitset of the bands having at least
+     * one block allocated. Blocks allocated to each UE are in the UE's own table.
+     */
+    class BandOccupancy
     {
-        /// Stores for each UE the amount of blocks allocated in the structure band
-        UeAllocatedBlocksMap ueAllocatedRbsMap_;
-        /// Stores for each UE the amount of bytes allocated in the structure band
-        UeAllocatedBytesMap ueAllocatedBytesMap_;
+        typedef std::bitset<64> Word;
 
-        /// Stores the amount of blocks allocated to every UE in the structure band
-        unsigned int allocated_;
+        std::vector<unsigned int> allocated_;
+        std::vector<Word> occupied_;
 
-        AllocatedRbsPerBandInfo()
+      public:
+
+        // clears the occupancy of all the bands (storage is kept)
+        void reset(unsigned int bands)
         {
-            allocated_ = 0;
+            allocated_.assign(bands, 0);
+            occupied_.assign((bands + 63) / 64, Word());
         }
-    };
 
-    typedef std::map<Band, AllocatedRbsPerBandInfo> AllocatedRbsPerBandMap;
+        unsigned int getBlocks(Band band) const
+        {
+            return (band < allocated_.size()) ? allocated_[band] : 0;
+        }
+
+        void setBlocks(Band band, unsigned int blocks)
+        {
+            allocated_.at(band) = blocks;
+            occupied_[band / 64].set(band % 64, blocks > 0);
+        }
+
+        bool isOccupied(Band band) const
+        {
+            return band < allocated_.size() && occupied_[band / 64].test(band % 64);
+        }
+
+        // number of bands with at least one block allocated
+        unsigned int getOccupiedBands() const
+        {
+            unsigned int count = 0;
+            for (unsigned int i = 0; i < occupied_.size(); i++)
+                count += occupied_[i].count();
+            return count;
+        }
+    };
 
   protected:
 
     /**
-     * e.g. allocatedRbsBand_ [ <plane> ] [ <antenna> ] [ <band> ] give the the amount of blocks allocated for each UE
+     * e.g. bandOccupancy_ [ <plane> ] [ <antenna> ] gives the amount of blocks allocated in each band
      */
-    std::vector<std::vector<AllocatedRbsPerBandMap> > allocatedRbsPerBand_;
+    std::vector<std::vector<BandOccupancy> > bandOccupancy_;
 
     /*
      * Stores the block-allocation info of the previous TTI in order to use them for interference computation
      */
-    std::vector<std::vector<AllocatedRbsPerBandMap> > prevAllocatedRbsPerBand_;
+    std::vector<std::vector<BandOccupancy> > prevBandOccupancy_;
+
+    // index of the given remote and band in the tables of AllocatedRbsPerUeInfo
+    unsigned int ueIndex(const Remote antenna, const Band band) const
+    {
+        return antenna * bands_ + band;
+    }
+
+    // makes room for the given remote in the tables of the given UE
+    void resizeUeTables(AllocatedRbsPerUeInfo& info, const Remote antenna);
+
+    // adds a (plane, antenna) space to the band occupancy tables
+    void resizeBandOccupancy(const Plane plane, const unsigned int antennas);
 
   public:
 
@@ -231,8 +261,9 @@ class LteAllocationModule
      */
     unsigned int getBlocks(const Remote antenna, const Band band, const MacNodeId nodeId)
     {
-        Plane plane = allocatedRbsUe_[nodeId].secondaryUser_ ? MU_MIMO_PLANE : MAIN_PLANE;
-        return allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[nodeId];
+        const AllocatedRbsPerUeInfo& info = allocatedRbsUe_[nodeId];
+        unsigned int index = ueIndex(antenna, band);
+        return (index < info.ueAllocatedRbs_.size()) ? info.ueAllocatedRbs_[index] : 0;
     }
 
     /*
@@ -243,8 +274,9 @@ class LteAllocationModule
 
     unsigned int getBytes(const Remote antenna, const Band band, const MacNodeId nodeId)
     {
-        Plane plane = allocatedRbsUe_[nodeId].secondaryUser_ ? MU_MIMO_PLANE : MAIN_PLANE;
-        return allocatedRbsPerBand_[plane][antenna][band].ueAllocatedBytesMap_[nodeId];
+        const AllocatedRbsPerUeInfo& info = allocatedRbsUe_[nodeId];
+        unsigned int index = ueIndex(antenna, band);
+        return (index < info.ueAllocatedBytes_.size()) ? info.ueAllocatedBytes_[index] : 0;
     }
 
     // computes the amount of blocks allocated by the given UE
@@ -283,12 +315,16 @@ class LteAllocationModule
     AllocationList::const_iterator getAllocatedBlocksUeAllocationListBegin(const Remote antenna, const Band b,
         const MacNodeId nodeId)
     {
-        return allocatedRbsUe_[nodeId].allocationMap_[antenna][b].begin();
+        AllocatedRbsPerUeInfo& info = allocatedRbsUe_[nodeId];
+        resizeUeTables(info, antenna);
+        return info.allocationList_[ueIndex(antenna, b)].begin();
     }
     AllocationList::const_iterator getAllocatedBlocksUeAllocationListEnd(const Remote antenna, const Band b,
         const MacNodeId nodeId)
     {
-        return allocatedRbsUe_[nodeId].allocationMap_[antenna][b].end();
+        AllocatedRbsPerUeInfo& info = allocatedRbsUe_[nodeId];
+        resizeUeTables(info, antenna);
+        return info.allocationList_[ueIndex(antenna, b)].end();
     }
 
     /*
@@ -43,9 +43,6 @@ void LteAllocationModuleFrequencyReuse::storeAllocation( std::vector<std::vector
 
             while(it_ext!=et_ext)
             {
-                allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[it_ext->first] = it_ext->second;    // Blocks
-                allocatedRbsPerBand_[plane][antenna][band].ueAllocatedBytesMap_[it_ext->first] = it2_ext->second; // Bytes
-
                 // Creates a pair (a key) for the Map
                 std::pair<MacNodeId,Band> Key_pair (it_ext->first,band);
                 // Creates a pair for the blocks and bytes values
@@ -56,7 +53,7 @@ void LteAllocationModuleFrequencyReuse::storeAllocation( std::vector<std::vector
                 it2_ext++;
             }
             // Copy the allocatedRbsPerBand
-            allocatedRbsPerBand_[plane][antenna][band].allocated_ = allocatedRbsPerBand[plane][antenna][band].allocated_;
+            bandOccupancy_[plane][antenna].setBlocks(band, allocatedRbsPerBand[plane][antenna][band].allocated_);
 
             if (allocatedRbsPerBand[plane][antenna][band].allocated_ > 0)
                 allocatedRbsMatrix_[MAIN_PLANE][MACRO] ++;
@@ -69,16 +66,20 @@ void LteAllocationModuleFrequencyReuse::storeAllocation( std::vector<std::vector
         // Skip allocation if the band is untouchable (this means that the informations are already allocated)
         if( untouchableBands->find(it_rbsB->first.second) == untouchableBands->end() )
         {
-            allocatedRbsUe_[it_rbsB->first.first].ueAllocatedRbsMap_[antenna][it_rbsB->first.second] = it_rbsB->second.first; //Blocks
-            allocatedRbsUe_[it_rbsB->first.first].allocatedBlocks_ += it_rbsB->second.first; //Blocks
-            allocatedRbsUe_[it_rbsB->first.first].allocatedBytes_ += it_rbsB->second.second; //Bytes
+            AllocatedRbsPerUeInfo& info = allocatedRbsUe_[it_rbsB->first.first];
+            resizeUeTables(info, antenna);
+            unsigned int index = ueIndex(antenna, it_rbsB->first.second);
+            info.ueAllocatedRbs_[index] = it_rbsB->second.first; //Blocks
+            info.ueAllocatedBytes_[index] = it_rbsB->second.second; //Bytes
+            info.allocatedBlocks_ += it_rbsB->second.first; //Blocks
+            info.allocatedBytes_ += it_rbsB->second.second; //Bytes
 
             // Creates and store the allocation Elem
             AllocationElem elem;
             elem.resourceBlocks_ = it_rbsB->second.first;
             elem.bytes_ = it_rbsB->second.second;
 
-            allocatedRbsUe_[it_rbsB->first.first].allocationMap_[antenna][it_rbsB->first.second].push_back(elem);
+            info.allocationList_[index].push_back(elem);
         }
         it_rbsB++;
     }
@@ -89,9 +90,12 @@ std::set<Band>  LteAllocationModuleFrequencyReuse::getAllocatorOccupiedBands()
     // TODO add support for logical band different from the number of real bands
     std::set<Band> vectorBand;
     vectorBand.clear();
+    const BandOccupancy& occupancy = bandOccupancy_[MAIN_PLANE][MACRO];
+    if (occupancy.getOccupiedBands() == 0)
+        return vectorBand;
     for(unsigned int i=0;i<bands_;i++)
     {
-        if( allocatedRbsPerBand_[MAIN_PLANE][MACRO][i].allocated_>0 ) vectorBand.insert(i);
+        if( occupancy.isOccupied(i) ) vectorBand.insert(i);
 
     }
     return vectorBand;
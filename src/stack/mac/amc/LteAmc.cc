@@ -7,6 +7,7 @@
 // and cannot be removed from it.
 //
 //
+#include <algorithm>
 #include <omnetpp.h>
 
 #include "stack/mac/amc/LteAmc.h"
@@ -237,6 +238,10 @@ void LteAmc::initialize()
     allocationType_ = getRbAllocationType(mac_->par("rbAllocationType").stringValue());
     lb_ = mac_->par("summaryLowerBound");
     ub_ = mac_->par("summaryUpperBound");
+    tbsMemoization_ = mac_->par("tbsMemoization");
+    tbsRowCacheEpoch_ = -1;
+    txParamsVersion_ = 1;
+    allTxParamsVersion_ = txParamsVersion_;
 
     printParameters();
 
@@ -355,6 +360,7 @@ void LteAmc::initialize()
 
 void LteAmc::rescaleMcs(double rePerRb, Direction dir)
 {
+    invalidateTxParams();
     if (dir == DL)
     {
         dlMcsTable_.rescale(rePerRb);
@@ -372,7 +378,7 @@ void LteAmc::rescaleMcs(double rePerRb, Direction dir)
  *    Functions for feedback management    *
  *******************************************/
 
-void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb)
+void LteAmc::pushFeedback(MacNodeId id, Direction dir, const LteFeedback& fb)
 {
     EV << "Feedback from MacNodeId " << id << " (direction " << dirToA(dir) << ")" << endl;
 
@@ -406,6 +412,7 @@ void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb)
     EV << "ID: " << id << endl;
     EV << "index: " << index << endl;
     (*history)[antenna].at(index).at(txMode).put(fb);
+    invalidateTxParams(id);
 
     // DEBUG
 //    printFbhb(dir);
@@ -416,7 +423,7 @@ void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb)
 //    (*history)[antenna].at(index).at(txMode).get().print(0,id,dir,txMode,"LteAmc::pushFeedback");
 }
 
-void LteAmc::pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId)
+void LteAmc::pushFeedbackD2D(MacNodeId id, const LteFeedback& fb, MacNodeId peerId)
 {
     EV << "Feedback from MacNodeId " << id << " (direction D2D), peerId = " << peerId << endl;
 
@@ -444,8 +451,12 @@ void LteAmc::pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId)
             newHist[antenna].push_back(std::vector<LteSummaryBuffer>(UL_NUM_TXMODE, LteSummaryBuffer(fbhbCapacityD2D_, MAXCW, numBands_, lb_, ub_)));
         }
         (*history)[peerId] = newHist;
+
+        // the D2D tx params of the other nodes may be computed on the new peer (see AmcPilotD2D::computeTxParams())
+        invalidateTxParams();
     }
     (*history)[peerId][antenna].at(index).at(txMode).put(fb);
+    invalidateTxParams(id);
 
     // DEBUG
     EV << "PeerId: " << peerId << ", Antenna: " << dasToA(antenna) << ", TxMode: " << txMode << ", Index: " << index << endl;
@@ -454,7 +465,7 @@ void LteAmc::pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId)
 }
 
 
-LteSummaryFeedback LteAmc::getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir)
+const LteSummaryFeedback& LteAmc::getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir)
 {
     MacNodeId nh = getNextHop(id);
     if (id != nh)
@@ -471,7 +482,7 @@ LteSummaryFeedback LteAmc::getFeedback(MacNodeId id, Remote antenna, TxMode txMo
     }
 }
 
-LteSummaryFeedback LteAmc::getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId)
+const LteSummaryFeedback& LteAmc::getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId)
 {
     MacNodeId nh = getNextHop(id);
 
@@ -604,8 +615,19 @@ const UserTxParams& LteAmc::computeTxParams(MacNodeId id, const Direction dir)
     return info;
 }
 
+unsigned long LteAmc::getTxParamsVersion(MacNodeId id)
+{
+    // the tx params of a node are the ones of its next hop (see computeTxParams())
+    id = getNextHop(id);
+    unsigned long nodeVersion = (id < nodeTxParamsVersion_.size()) ? nodeTxParamsVersion_[id] : 0;
+    return std::max(allTxParamsVersion_, nodeVersion);
+}
+
 void LteAmc::cleanAmcStructures(Direction dir, ActiveSet aUser)
 {
+    // the tx params are cleared below, but they will be computed again from the same
+    // feedback: their version does not change
+    tbsRowCache_.clear();
     EV << NOW << " LteAmc::cleanAmcStructures. Direction " << dirToA(dir) << endl;
 
     //Convert from active cid to active users
@@ -643,6 +665,43 @@ void LteAmc::cleanAmcStructures(Direction dir, ActiveSet aUser)
      *      Scheduler interface functions      *
      *******************************************/
 
+const std::vector<LteAmc::TbsRowInfo>& LteAmc::getTbsRows(MacNodeId id, const Direction dir)
+{
+    std::vector<TbsRowInfo>* rows = &tbsRows_;
+    if (tbsMemoization_)
+    {
+        if (tbsRowCacheEpoch_ != NOW)
+        {
+            tbsRowCache_.clear();
+            tbsRowCacheEpoch_ = NOW;
+        }
+
+        std::pair<MacNodeId, Direction> key(id, dir);
+        TbsRowCache::iterator it = tbsRowCache_.find(key);
+        if (it != tbsRowCache_.end())
+            return it->second;
+        rows = &tbsRowCache_[key];
+    }
+
+    const UserTxParams& info = computeTxParams(id, dir);
+    const std::vector<unsigned char>& layers = info.getLayers();
+
+    rows->resize(layers.size());
+    for (Codeword cw = 0; cw < layers.size(); ++cw)
+    {
+        TbsRowInfo& row = (*rows)[cw];
+        row.cqi = info.readCqiVector().at(cw);
+
+        LteMod mod = info.getCwModulation(cw);
+        row.iTbs = getItbsPerCqi(row.cqi, dir);
+        unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
+
+        row.tbs = itbs2tbs(mod, info.readTxMode(), layers.at(cw), row.iTbs - i);
+        row.tbsMax = itbs2tbsMax(mod, info.readTxMode(), layers.at(cw), row.iTbs - i);
+    }
+    return *rows;
+}
+
 unsigned int LteAmc::computeReqRbs(MacNodeId id, Band b, Codeword cw, unsigned int bytes, const Direction dir)
 {
     EV << NOW << " LteAmc::getRbs Node " << id << ", Band " << b << ", Codeword " << cw << ", direction " << dirToA(dir) << endl;
@@ -657,23 +716,13 @@ unsigned int LteAmc::computeReqRbs(MacNodeId id, Band b, Codeword cw, unsigned i
     }
 
     // Loading TBS vectors
-    const unsigned int* tbsVect;// it is a row of the itbs matrix
-    UserTxParams info = computeTxParams(id, dir);
-    unsigned char layers = info.getLayers().at(cw);
-
-    LteMod mod = info.getCwModulation(cw);
-    unsigned int iTbs = getItbsPerCqi(info.readCqiVector().at(cw), dir);
-    unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
-    tbsVect = itbs2tbs(mod, info.readTxMode(), layers, iTbs-i);
+    const TbsRowInfo& row = getTbsRows(id, dir).at(cw);
 
     // Computing RB occupation
-    unsigned int j;
-    for(j = 0; j < 110; ++j)
-    if(tbsVect[j] >= bytes*8)
-    break;
+    unsigned int j = tbsLowerBound(row.tbsMax, bytes*8);
 
     // DEBUG
-    EV << NOW << " LteAmc::getRbs Occupation: " << bytes << " bytes , CQI : " << info.readCqiVector().at(cw) << " \n";
+    EV << NOW << " LteAmc::getRbs Occupation: " << bytes << " bytes , CQI : " << row.cqi << " \n";
     EV << NOW << " LteAmc::getRbs Number of RBs: " << j+1 << "\n";
 
     return j+1;
@@ -693,36 +742,27 @@ unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks
     EV << NOW << " LteAmc::blocks2bits Direction: " << dirToA(dir) << "\n";
 
     // Acquiring current user scheduling information
-    const UserTxParams & info = computeTxParams(id, dir);
-
-    std::vector<unsigned char> layers = info.getLayers();
+    const std::vector<TbsRowInfo>& rows = getTbsRows(id, dir);
 
     unsigned int bits = 0;
-    unsigned int codewords = layers.size();
+    unsigned int codewords = rows.size();
     for (Codeword cw = 0; cw < codewords; ++cw)
     {
         // if CQI == 0 the UE is out of range, thus bits=0
-        if (info.readCqiVector().at(cw) == 0)
+        if (rows[cw].cqi == 0)
         {
             EV << NOW << " LteAmc::blocks2bits - CQI equal to zero on cw " << cw << ", return no blocks available" << endl;
             continue;
         }
 
-        LteMod mod = info.getCwModulation(cw);
-        unsigned int iTbs = getItbsPerCqi(info.readCqiVector().at(cw), dir);
-        unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
-
         // DEBUG
         EV << NOW << " LteAmc::blocks2bits ---::[ Codeword = " << cw << "\n";
-        EV << NOW << " LteAmc::blocks2bits Modulation: " << modToA(mod) << "\n";
-        EV << NOW << " LteAmc::blocks2bits iTbs: " << iTbs << "\n";
-        EV << NOW << " LteAmc::blocks2bits i: " << i << "\n";
-        EV << NOW << " LteAmc::blocks2bits CQI: " << info.readCqiVector().at(cw) << "\n";
+        EV << NOW << " LteAmc::blocks2bits iTbs: " << rows[cw].iTbs << "\n";
+        EV << NOW << " LteAmc::blocks2bits CQI: " << rows[cw].cqi << "\n";
 
-        mac_->emitItbs(iTbs);
+        mac_->emitItbs(rows[cw].iTbs);
 
-        const unsigned int* tbsVect = itbs2tbs(mod, info.readTxMode(), layers.at(cw), iTbs-i);
-        bits += tbsVect[blocks-1];
+        bits += rows[cw].tbs[blocks-1];
     }
 
             // DEBUG
@@ -747,26 +787,19 @@ unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsign
     EV << NOW << " LteAmc::blocks2bits Direction: " << dirToA(dir) << "\n";
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir);
+    const TbsRowInfo& row = getTbsRows(id, dir).at(cw);
 
     // if CQI == 0 the UE is out of range, thus return 0
-    if (info.readCqiVector().at(cw) == 0)
+    if (row.cqi == 0)
     {
         EV << NOW << " LteAmc::blocks2bits - CQI equal to zero, return no blocks available" << endl;
         return 0;
     }
-    unsigned char layers = info.getLayers().at(cw);
-
-    unsigned int iTbs = getItbsPerCqi(info.readCqiVector().at(cw), dir);
-    LteMod mod = info.getCwModulation(cw);
-    unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
 
     // DEBUG
-    EV << NOW << " LteAmc::blocks2bits Modulation: " << modToA(mod) << "\n";
-    EV << NOW << " LteAmc::blocks2bits iTbs: " << iTbs << "\n";
-    EV << NOW << " LteAmc::blocks2bits i: " << i << "\n";
+    EV << NOW << " LteAmc::blocks2bits iTbs: " << row.iTbs << "\n";
 
-    const unsigned int* tbsVect = itbs2tbs(mod, info.readTxMode(), layers, iTbs - i);
+    const unsigned int* tbsVect = row.tbs;
 
     // DEBUG
     EV << NOW << " LteAmc::blocks2bits Resource Blocks: " << blocks << "\n";
@@ -837,7 +870,7 @@ unsigned int LteAmc::computeBitsOnNRbs_MB(MacNodeId id, Band b,  unsigned int bl
     Cqi cqi = readMultiBandCqi(id,dir)[b];
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir);
+    const UserTxParams& info = computeTxParams(id, dir);
 
     std::vector<unsigned char> layers = info.getLayers();
 
@@ -870,6 +903,7 @@ unsigned int LteAmc::computeBitsOnNRbs_MB(MacNodeId id, Band b,  unsigned int bl
 bool LteAmc::setPilotUsableBands(MacNodeId id , std::vector<unsigned short>  usableBands)
 {
     pilot_->setUsableBands(id,usableBands);
+    invalidateTxParams(id);
     return true;
 }
 
@@ -1270,6 +1304,7 @@ Pmi LteAmc::readWbPmi(const PmiVector& pmi)
 
 void LteAmc::detachUser(MacNodeId nodeId, Direction dir)
 {
+    invalidateTxParams();
     EV << "##################################" << endl;
     EV << "# LteAmc::detachUser. Id: " << nodeId << ", direction: " << dirToA(dir) << endl;
     EV << "##################################" << endl;
@@ -1349,6 +1384,7 @@ void LteAmc::detachUser(MacNodeId nodeId, Direction dir)
 
 void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
 {
+    invalidateTxParams();
     EV << "##################################" << endl;
     EV << "# LteAmc::attachUser. Id: " << nodeId << ", direction: " << dirToA(dir) << endl;
     EV << "##################################" << endl;
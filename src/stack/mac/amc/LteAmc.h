@@ -89,6 +89,62 @@ class LteAmc
     LteMuMimoMatrix muMimoDlMatrix_;
     LteMuMimoMatrix muMimoUlMatrix_;
     LteMuMimoMatrix muMimoD2DMatrix_;
+
+    /*
+     * TBS rows selected by the tx params of a node, one per codeword
+     */
+    struct TbsRowInfo
+    {
+        Cqi cqi;
+        unsigned int iTbs;
+        // row of the itbs2tbs table and its running maximum (see itbs2tbsMax())
+        const unsigned int* tbs;
+        const unsigned int* tbsMax;
+    };
+    typedef std::map<std::pair<MacNodeId, Direction>, std::vector<TbsRowInfo> > TbsRowCache;
+
+    // if true, the TBS rows are computed once per TTI (see getTbsRows())
+    bool tbsMemoization_;
+    TbsRowCache tbsRowCache_;
+    omnetpp::simtime_t tbsRowCacheEpoch_;
+    // used in place of the cache when memoization is disabled
+    std::vector<TbsRowInfo> tbsRows_;
+
+    // incremented whenever the inputs of the tx params computation change
+    unsigned long txParamsVersion_;
+    // value of txParamsVersion_ at the last change of the tx params of all the nodes,
+    // and of the tx params of each node (indexed by MacNodeId)
+    unsigned long allTxParamsVersion_;
+    std::vector<unsigned long> nodeTxParamsVersion_;
+
+    /*
+     * Returns the TBS rows of the given node, computing its tx params if needed.
+     * With memoization enabled, the result is cached until the end of the TTI
+     * or until the tx params may change (see invalidateTxParams())
+     */
+    const std::vector<TbsRowInfo>& getTbsRows(MacNodeId id, const Direction dir);
+
+    /*
+     * To be called whenever the tx params of all the nodes may change
+     * (MCS scaling, attach/detach)
+     */
+    void invalidateTxParams()
+    {
+        allTxParamsVersion_ = ++txParamsVersion_;
+        tbsRowCache_.clear();
+    }
+
+    /*
+     * To be called whenever the tx params of the given node may change
+     * (new feedback, usable bands)
+     */
+    void invalidateTxParams(MacNodeId id)
+    {
+        if (id >= nodeTxParamsVersion_.size())
+            nodeTxParamsVersion_.resize(id + 1, 0);
+        nodeTxParamsVersion_[id] = ++txParamsVersion_;
+        tbsRowCache_.clear();
+    }
     public:
     LteAmc(LteMacEnb *mac, LteBinder *binder, LteCellInfo *cellInfo, int numAntennas);
     void initialize();
@@ -105,10 +161,10 @@ class LteAmc
     // CodeRate MCS rescaling
     void rescaleMcs(double rePerRb, Direction dir = DL);
 
-    void pushFeedback(MacNodeId id, Direction dir, LteFeedback fb);
-    void pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId);
-    LteSummaryFeedback getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir);
-    LteSummaryFeedback getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId);
+    void pushFeedback(MacNodeId id, Direction dir, const LteFeedback& fb);
+    void pushFeedbackD2D(MacNodeId id, const LteFeedback& fb, MacNodeId peerId);
+    const LteSummaryFeedback& getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir);
+    const LteSummaryFeedback& getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId);
 
     //used when is necessary to know if the requested feedback exists or not
     // LteSummaryFeedback getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir,bool& valid);
@@ -130,6 +186,12 @@ class LteAmc
     const UserTxParams & getTxParams(MacNodeId id, const Direction dir);
     const UserTxParams & setTxParams(MacNodeId id, const Direction dir, UserTxParams & info);
     const UserTxParams & computeTxParams(MacNodeId id, const Direction dir);
+    /*
+     * Returns a counter that changes whenever the result of computeTxParams() for the given
+     * node may change. Schedulers can use it to reuse values derived from the tx params of a node
+     */
+    unsigned long getTxParamsVersion(MacNodeId id);
+
     void cleanAmcStructures(Direction dir, ActiveSet aUser);
     unsigned int computeReqRbs(MacNodeId id, Band b, Codeword cw, unsigned int bytes, const Direction dir);
     unsigned int computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks, const Direction dir);
@@ -7,6 +7,8 @@
 // and cannot be removed from it.
 //
 
+#include <algorithm>
+
 #include "stack/mac/amc/LteMcs.h"
 
 using namespace omnetpp;
@@ -319,6 +321,81 @@ const unsigned int* itbs2tbs(LteMod mod, TxMode txMode, unsigned char layers, un
     return res;
 }
 
+namespace {
+
+/*
+ * Running maximum of the rows of a TBS table, with the same layout as the table
+ */
+class TbsMaxTable
+{
+    std::vector<unsigned int> max_;
+
+  public:
+    template<size_t ROWS>
+    TbsMaxTable(const unsigned int (&table)[ROWS][110]) :
+        max_(ROWS * 110)
+    {
+        for (size_t i = 0; i < ROWS; ++i)
+        {
+            unsigned int* row = &max_[i * 110];
+            row[0] = table[i][0];
+            for (unsigned int j = 1; j < 110; ++j)
+                row[j] = std::max(row[j-1], table[i][j]);
+        }
+    }
+
+    const unsigned int* operator[](unsigned int itbs) const { return &max_[itbs * 110]; }
+};
+
+const TbsMaxTable itbs2tbsMax_qpsk_1(itbs2tbs_qpsk_1);
+const TbsMaxTable itbs2tbsMax_16qam_1(itbs2tbs_16qam_1);
+const TbsMaxTable itbs2tbsMax_64qam_1(itbs2tbs_64qam_1);
+const TbsMaxTable itbs2tbsMax_qpsk_2(itbs2tbs_qpsk_2);
+const TbsMaxTable itbs2tbsMax_16qam_2(itbs2tbs_16qam_2);
+const TbsMaxTable itbs2tbsMax_64qam_2(itbs2tbs_64qam_2);
+const TbsMaxTable itbs2tbsMax_qpsk_4(itbs2tbs_qpsk_4);
+const TbsMaxTable itbs2tbsMax_16qam_4(itbs2tbs_16qam_4);
+const TbsMaxTable itbs2tbsMax_64qam_4(itbs2tbs_64qam_4);
+
+}
+
+const unsigned int* itbs2tbsMax(LteMod mod, TxMode txMode, unsigned char layers, unsigned char itbs)
+{
+    // same table selection as itbs2tbs()
+    const TbsMaxTable* table[3];
+    if (layers == 1 || (txMode != OL_SPATIAL_MULTIPLEXING && txMode != CL_SPATIAL_MULTIPLEXING))
+    {
+        table[_QPSK] = &itbs2tbsMax_qpsk_1;
+        table[_16QAM] = &itbs2tbsMax_16qam_1;
+        table[_64QAM] = &itbs2tbsMax_64qam_1;
+    }
+    else if (layers == 2)
+    {
+        table[_QPSK] = &itbs2tbsMax_qpsk_2;
+        table[_16QAM] = &itbs2tbsMax_16qam_2;
+        table[_64QAM] = &itbs2tbsMax_64qam_2;
+    }
+    else if (layers == 4)
+    {
+        table[_QPSK] = &itbs2tbsMax_qpsk_4;
+        table[_16QAM] = &itbs2tbsMax_16qam_4;
+        table[_64QAM] = &itbs2tbsMax_64qam_4;
+    }
+    else
+        throw cRuntimeError("Illegal number of layers in LteAmc::itbs2tbsMax()");
+
+    if (mod != _QPSK && mod != _16QAM && mod != _64QAM)
+        throw cRuntimeError("Unknown MCS (%d) in LteAmc::itbs2tbsMax()", mod);
+
+    return (*table[mod])[itbs];
+}
+
+unsigned int tbsLowerBound(const unsigned int* tbsRowMax, unsigned int bits)
+{
+    // the first entry of the row not less than bits is also the first entry of its running maximum
+    return std::lower_bound(tbsRowMax, tbsRowMax + 110, bits) - tbsRowMax;
+}
+
 std::vector<unsigned char> cwMapping(const TxMode& txMode, const Rank& ri, const unsigned int antennaPorts)
 {
     std::vector<unsigned char> res;
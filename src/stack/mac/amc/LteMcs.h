@@ -102,6 +102,27 @@ extern const unsigned int itbs2tbs_64qam8[][110];
  */
 const unsigned int* itbs2tbs(LteMod mod, TxMode txMode, unsigned char layers, unsigned char itbs);
 
+/**
+ * Gives the running maximum of a TBS row, i.e. entry j is the largest TBS
+ * carried by at most j+1 blocks. Unlike the rows of some multi-layer tables,
+ * it is non-decreasing, hence it can be binary searched.
+ * The running maxima of all the rows are computed once, at startup.
+ * @param mod The modulation.
+ * @param txMode The transmission mode.
+ * @param layers The number of layers.
+ * @param itbs The iTBS, with the same offset as in itbs2tbs().
+ * @return The running maximum of the row returned by itbs2tbs() (110 entries).
+ */
+const unsigned int* itbs2tbsMax(LteMod mod, TxMode txMode, unsigned char layers, unsigned char itbs);
+
+/**
+ * Gives the index of the first entry of a TBS row that is not less than the given size.
+ * @param tbsRowMax The running maximum of the row, see itbs2tbsMax().
+ * @param bits The size to be carried.
+ * @return The index of the entry, or 110 if the size does not fit in 110 blocks.
+ */
+unsigned int tbsLowerBound(const unsigned int* tbsRowMax, unsigned int bits);
+
 /**
  * Gives the number of layers for each codeword.
  * @param txMode The transmission mode.
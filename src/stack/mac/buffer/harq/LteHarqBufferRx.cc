@@ -118,6 +118,19 @@ unsigned int LteHarqBufferRx::purgeCorruptedPdus()
     return purged;
 }
 
+bool LteHarqBufferRx::isEmpty()
+{
+    for (unsigned int i = 0; i < numHarqProcesses_; i++)
+    {
+        for (Codeword cw = 0; cw < MAX_CODEWORDS; ++cw)
+        {
+            if (processes_[i]->getUnitStatus(cw) != RXHARQ_PDU_EMPTY)
+                return false;
+        }
+    }
+    return true;
+}
+
 std::list<LteMacPdu *> LteHarqBufferRx::extractCorrectPdus()
 {
     this->sendFeedback();
@@ -87,6 +87,11 @@ class LteHarqBufferRx
      */
     unsigned int purgeCorruptedPdus();
 
+    /**
+     * @return true if no process contains a pdu, i.e. there is no pending feedback or pdu to extract
+     */
+    bool isEmpty();
+
     /*
      * Returns pointer to <acid> process.
      */
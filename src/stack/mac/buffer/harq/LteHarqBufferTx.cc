@@ -293,6 +293,16 @@ void LteHarqBufferTx::forceDropUnit(unsigned char acid, Codeword cw)
     }
 }
 
+bool LteHarqBufferTx::isEmpty()
+{
+    for (unsigned int i = 0; i < numProc_; i++)
+    {
+        if (!(*processes_)[i]->isEmpty())
+            return false;
+    }
+    return true;
+}
+
 BufferStatus LteHarqBufferTx::getBufferStatus()
 {
     BufferStatus bs(numProc_);
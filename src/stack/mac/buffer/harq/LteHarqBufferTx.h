@@ -173,6 +173,11 @@ class LteHarqBufferTx
 
     BufferStatus getBufferStatus();
 
+    /**
+     * @return true if all the processes are empty, i.e. there is nothing to (re)transmit
+     */
+    bool isEmpty();
+
     std::vector<LteHarqProcessTx *> * getHarqProcesses(){ return processes_ ; }
     unsigned int getNumProcesses() { return numProc_; }
 
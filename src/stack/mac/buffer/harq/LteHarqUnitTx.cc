@@ -37,6 +37,7 @@ LteHarqUnitTx::LteHarqUnitTx(unsigned char acid, Codeword cw,
         harqErrorRate_2_ = dstMac_->registerSignal("harqErrorRate_2nd_Dl");
         harqErrorRate_3_ = dstMac_->registerSignal("harqErrorRate_3rd_Dl");
         harqErrorRate_4_ = dstMac_->registerSignal("harqErrorRate_4th_Dl");
+        harqRtt_ = dstMac_->registerSignal("harqRttDl");
     }
     else  // UE
     {
@@ -50,6 +51,7 @@ LteHarqUnitTx::LteHarqUnitTx(unsigned char acid, Codeword cw,
             harqErrorRate_2_ = macOwner_->registerSignal("harqErrorRate_2nd_Ul");
             harqErrorRate_3_ = macOwner_->registerSignal("harqErrorRate_3rd_Ul");
             harqErrorRate_4_ = macOwner_->registerSignal("harqErrorRate_4th_Ul");
+            harqRtt_ = macOwner_->registerSignal("harqRttUl");
         }
     }
 }
@@ -190,6 +192,8 @@ bool LteHarqUnitTx::pduFeedback(HarqAcknowledgment a)
     }
 
     ue->emit(harqErrorRate_, sample);
+    // time elapsed between the (re)transmission and its feedback
+    ue->emit(harqRtt_, NOW - txTime_);
 
     if (reset)
     {
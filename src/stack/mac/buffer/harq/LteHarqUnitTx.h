@@ -77,6 +77,7 @@ class LteHarqUnitTx
     omnetpp::simsignal_t harqErrorRate_2_;
     omnetpp::simsignal_t harqErrorRate_3_;
     omnetpp::simsignal_t harqErrorRate_4_;
+    omnetpp::simsignal_t harqRtt_;
 
     // D2D Statistics
     omnetpp::simsignal_t macCellPacketLossD2D_;
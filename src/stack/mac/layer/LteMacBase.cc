@@ -24,6 +24,8 @@ using namespace omnetpp;
 
 LteMacBase::LteMacBase()
 {
+    ttiTick_ = NULL;
+    flushHarqMsg_ = NULL;
     mbuf_.clear();
     macBuffers_.clear();
 }
@@ -337,6 +339,10 @@ void LteMacBase::initialize(int stage)
         ttiTick_->setSchedulingPriority(1);        // TTI TICK after other messages
         scheduleAt(NOW + TTI, ttiTick_);
 
+        // Message that triggers flushing of Tx H-ARQ buffers
+        flushHarqMsg_ = new cMessage("flushHarqMsg");
+        flushHarqMsg_->setSchedulingPriority(1);        // after other messages
+
         /* statistics */
         statDisplay_ = par("statDisplay");
         totalOverflowedBytes_ = 0;
@@ -361,6 +367,21 @@ void LteMacBase::initialize(int stage)
         WATCH_MAP(mbuf_);
         WATCH_MAP(macBuffers_);
     }
+    else if (stage == inet::INITSTAGE_TRANSPORT_LAYER)
+    {
+        // the node id is known at this stage, for both eNBs and UEs
+        if (binder_->isGlobalTtiClock())
+        {
+            cancelEvent(ttiTick_);
+            binder_->getTtiClock()->registerClient(LteTtiClock::MAC_PHASE, nodeId_, this);
+        }
+    }
+}
+
+void LteMacBase::handleTti()
+{
+    Enter_Method_Silent("handleTti");
+    handleSelfMessage();
 }
 
 void LteMacBase::handleMessage(cMessage* msg)
@@ -401,6 +422,7 @@ void LteMacBase::finish()
 
 void LteMacBase::deleteModule(){
     cancelAndDelete(ttiTick_);
+    cancelAndDelete(flushHarqMsg_);
     cSimpleModule::deleteModule();
 }
 
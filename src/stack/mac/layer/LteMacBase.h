@@ -11,6 +11,7 @@
 #define _LTE_LTEMACBASE_H_
 
 #include "common/LteCommon.h"
+#include "corenetwork/binder/LteTtiClock.h"
 
 class LteHarqBufferTx;
 class LteHarqBufferRx;
@@ -46,9 +47,11 @@ typedef std::multimap<LteTrafficClass, CidBufferPair> LcgMap;
  * it performs buffering/sending packets.
  *
  * On each TTI, the handleSelfMessage() is called
- * to perform scheduling and other tasks
+ * to perform scheduling and other tasks.
+ * If the global TTI clock is enabled in the binder, the TTI self message
+ * is not used and handleSelfMessage() is called by the clock instead.
  */
-class LteMacBase : public omnetpp::cSimpleModule
+class LteMacBase : public omnetpp::cSimpleModule, public LteTtiClient
 {
     friend class LteHarqBufferTx;
     friend class LteHarqBufferRx;
@@ -88,6 +91,9 @@ class LteMacBase : public omnetpp::cSimpleModule
     /// TTI self message
     ::omnetpp::cMessage* ttiTick_;
 
+    /// self message triggering the flush of Tx H-ARQ buffers, reused on every TTI
+    ::omnetpp::cMessage* flushHarqMsg_;
+
     /// MacNodeId
     MacNodeId nodeId_;
 
@@ -257,6 +263,11 @@ class LteMacBase : public omnetpp::cSimpleModule
     // visualization
     void refreshDisplay() const override;
 
+    /**
+     * Called by the global TTI clock in place of the TTI self message
+     */
+    virtual void handleTti() override;
+
   protected:
 
     virtual int numInitStages() const override { return inet::NUM_INIT_STAGES; }
@@ -45,6 +45,8 @@ LteMacEnb::LteMacEnb() :
     frameIndex_ = 0;
     lastTtiAllocatedRb_ = 0;
     scheduleListDl_ = NULL;
+    scheduleListUl_ = NULL;
+    coordinatedScheduling_ = false;
 }
 
 LteMacEnb::~LteMacEnb()
@@ -274,19 +276,49 @@ void LteMacEnb::initialize(int stage)
         // register the pair <id,name> to the binder
         const char* moduleName = getParentModule()->getParentModule()->getFullName();
         binder_->registerName(nodeId_, moduleName);
+
+        // let the binder run the scheduling passes of all the eNBs as a group
+        coordinatedScheduling_ = binder_->isCoordinatedScheduling();
+        if (coordinatedScheduling_)
+            binder_->getTtiCoordinator()->registerMac(nodeId_, this);
     }
 }
 
+void LteMacEnb::finish()
+{
+    LteMacBase::finish();
+
+    if (enbSchedulerDl_ != NULL)
+        enbSchedulerDl_->recordProfiling();
+    if (enbSchedulerUl_ != NULL)
+        enbSchedulerUl_->recordProfiling();
+
+    unregisterFromCoordinator();
+}
+
+void LteMacEnb::deleteModule()
+{
+    unregisterFromCoordinator();
+    LteMacBase::deleteModule();
+}
+
+void LteMacEnb::unregisterFromCoordinator()
+{
+    // the coordinator must not keep a reference to a MAC that is going away.
+    // This is done at most once, since the binder may be deleted before this module
+    if (!coordinatedScheduling_)
+        return;
+
+    binder_->getTtiCoordinator()->unregisterMac(nodeId_);
+    coordinatedScheduling_ = false;
+}
+
 void LteMacEnb::handleMessage(cMessage *msg)
 {
-    if (msg->isSelfMessage())
+    if (msg == flushHarqMsg_)
     {
-        if (strcmp(msg->getName(), "flushHarqMsg") == 0)
-        {
-            flushHarqBuffers();
-            delete msg;
-            return;
-        }
+        flushHarqBuffers();
+        return;
     }
     LteMacBase::handleMessage(msg);
 }
@@ -824,6 +856,25 @@ void LteMacEnb::handleSelfMessage()
      *  MAIN LOOP  *
      ***************/
 
+    if (coordinatedScheduling_)
+    {
+        // the first TTI tick of the current TTI runs the scheduling phase of all the eNBs,
+        // then each eNB commits on its own tick. The packets sent during the scheduling phase
+        // (H-ARQ feedback, received SDUs) leave from the first tick, hence the event order
+        // differs from the sequential path
+        binder_->getTtiCoordinator()->runTti();
+        commitTti();
+        return;
+    }
+
+    scheduleTti();
+    commitTti();
+}
+
+void LteMacEnb::scheduleTti()
+{
+    Enter_Method_Silent("scheduleTti");
+
     EV << "-----" << "ENB MAIN LOOP -----" << endl;
 
     /*************
@@ -860,9 +911,13 @@ void LteMacEnb::handleSelfMessage()
 
     enbSchedulerUl_->updateHarqDescs();
 
-    LteMacScheduleList* scheduleListUl = enbSchedulerUl_->schedule();
-    // send uplink grants to PHY layer
-    sendGrants(scheduleListUl);
+    scheduleListUl_ = enbSchedulerUl_->schedule();
+    // send uplink grants to PHY layer (postponed to the commit phase when coordinated)
+    if (!coordinatedScheduling_)
+    {
+        sendGrants(scheduleListUl_);
+        scheduleListUl_ = NULL;
+    }
     EV << "============================================ END UPLINK ============================================" << endl;
 
     EV << "============================================ DOWNLINK ==============================================" << endl;
@@ -881,9 +936,6 @@ void LteMacEnb::handleSelfMessage()
 
         // perform Downlink scheduling
         scheduleListDl_ = enbSchedulerDl_->schedule();
-
-        // requests SDUs to the RLC layer
-        macSduRequest();
     }
     EV << "========================================== END DOWNLINK ============================================" << endl;
 
@@ -892,12 +944,26 @@ void LteMacEnb::handleSelfMessage()
     {
         hit->second->purgeCorruptedPdus();
     }
+}
+
+void LteMacEnb::commitTti()
+{
+    Enter_Method_Silent("commitTti");
+
+    // send uplink grants to PHY layer
+    if (scheduleListUl_ != NULL)
+    {
+        sendGrants(scheduleListUl_);
+        scheduleListUl_ = NULL;
+    }
+
+    // requests SDUs to the RLC layer
+    macSduRequest();
 
     // Message that triggers flushing of Tx H-ARQ buffers for all users
     // This way, flushing is performed after the (possible) reception of new MAC PDUs
-    cMessage* flushHarqMsg = new cMessage("flushHarqMsg");
-    flushHarqMsg->setSchedulingPriority(1);        // after other messages
-    scheduleAt(NOW, flushHarqMsg);
+    if (!flushHarqMsg_->isScheduled())
+        scheduleAt(NOW, flushHarqMsg_);
 
     EV << "--- END ENB MAIN LOOP ---" << endl;
 }
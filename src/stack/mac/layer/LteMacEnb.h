@@ -35,6 +35,12 @@ class LteMacEnb : public LteMacBase
     /// List of scheduled users - Downlink
     LteMacScheduleList* scheduleListDl_;
 
+    /// List of scheduled users - Uplink (valid between scheduleTti() and commitTti())
+    LteMacScheduleList* scheduleListUl_;
+
+    /// If true, the main loop is run by the TTI coordinator of the binder
+    bool coordinatedScheduling_;
+
     int eNodeBCount;
 
     /**
@@ -84,6 +90,22 @@ class LteMacEnb : public LteMacBase
      */
     virtual void handleMessage(omnetpp::cMessage *msg) override;
 
+    /**
+     * Records the scheduler profiling results, if enabled,
+     * and leaves the TTI coordinator
+     */
+    virtual void finish() override;
+
+    /**
+     * Leaves the TTI coordinator before the module is deleted
+     */
+    virtual void deleteModule() override;
+
+    /**
+     * Removes this MAC from the TTI coordinator of the binder, if registered
+     */
+    void unregisterFromCoordinator();
+
     /**
      * creates scheduling grants (one for each nodeId) according to the Schedule List.
      * It sends them to the  lower layer
@@ -186,6 +208,19 @@ class LteMacEnb : public LteMacBase
      */
     virtual void deleteQueues(MacNodeId nodeId) override;
 
+    /**
+     * First half of the main loop: extracts the received PDUs
+     * and runs the UL and DL schedulers. When coordinated, the
+     * UL grants are sent by commitTti()
+     */
+    virtual void scheduleTti();
+
+    /**
+     * Second half of the main loop: sends the UL grants,
+     * and requests the DL SDUs to the RLC layer
+     */
+    virtual void commitTti();
+
     /**
      * Getter for AMC module
      */
@@ -21,6 +21,7 @@
 #include "corenetwork/binder/LteBinder.h"
 #include "stack/phy/layer/LtePhyBase.h"
 #include "stack/mac/packet/LteMacSduRequest.h"
+#include "stack/phy/feedback/LteDlFeedbackGenerator.h"
 
 Define_Module(LteMacUe);
 
@@ -42,6 +43,13 @@ LteMacUe::LteMacUe() :
     scheduleList_ = NULL;
     debugHarq_ = false;
 
+    idleFastPath_ = false;
+    dormant_ = false;
+    dormantSince_ = 0;
+    skippedTtis_ = 0;
+    dormantTtis_ = 0;
+    fbGen_ = NULL;
+
     // TODO setup from NED
     racBackoffTimer_ = 0;
     maxRacTryouts_ = 0;
@@ -97,10 +105,18 @@ void LteMacUe::initialize(int stage)
         cqiDlSiso2_ = registerSignal("cqiDlSiso2");
         cqiDlSiso3_ = registerSignal("cqiDlSiso3");
         cqiDlSiso4_ = registerSignal("cqiDlSiso4");
+
+        idleFastPath_ = par("idleFastPath");
+        checkIdleFastPath_ = par("checkIdleFastPath");
+        WATCH(dormant_);
+        WATCH(dormantTtis_);
     }
     else if (stage == INITSTAGE_LINK_LAYER)
     {
         cellId_ = getAncestorPar("masterId");
+
+        if (idleFastPath_)
+            fbGen_ = dynamic_cast<LteDlFeedbackGenerator*>(getParentModule()->getSubmodule("dlFbGen"));
     }
     else if (stage == INITSTAGE_NETWORK_LAYER)
     {
@@ -140,16 +156,150 @@ void LteMacUe::initialize(int stage)
 
 void LteMacUe::handleMessage(cMessage* msg)
 {
-    if (msg->isSelfMessage())
+    if (msg == flushHarqMsg_)
     {
-        if (strcmp(msg->getName(), "flushHarqMsg") == 0)
-        {
-            flushHarqBuffers();
-            delete msg;
-            return;
-        }
+        flushHarqBuffers();
+        return;
     }
+
+    // any packet from the upper or the lower layer wakes the UE up
+    if (!msg->isSelfMessage())
+        wakeUp(msg->getArrivalGate() == down_[IN]);
+
     LteMacBase::handleMessage(msg);
+
+    if (msg == ttiTick_ && idleFastPath_ && isIdle())
+        enterDormancy();
+}
+
+void LteMacUe::handleTti()
+{
+    Enter_Method_Silent("handleTti");
+    if (dormant_)
+    {
+        skippedTtis_++;
+        if (!checkIdleFastPath_)
+            return;
+    }
+
+    LteMacBase::handleTti();
+
+    if (idleFastPath_ && isIdle())
+        enterDormancy();
+}
+
+void LteMacUe::finish()
+{
+    LteMacBase::finish();
+
+    if (idleFastPath_)
+        recordScalar("dormantTtis", dormantTtis_);
+}
+
+bool LteMacUe::isIdle()
+{
+    if (schedulingGrant_ != NULL || requestedSdus_ > 0 || bsrTriggered_)
+        return false;
+
+    // pending RAC procedure
+    if (racRequested_ || racBackoffTimer_ > 0 || raRespTimer_ > 0)
+        return false;
+
+    // pending H-ARQ flush
+    if (flushHarqMsg_->isScheduled())
+        return false;
+
+    LteMacBufferMap::const_iterator it;
+    for (it = macBuffers_.begin(); it != macBuffers_.end(); ++it)
+    {
+        if (!it->second->isEmpty())
+            return false;
+    }
+
+    HarqTxBuffers::iterator tit;
+    for (tit = harqTxBuffers_.begin(); tit != harqTxBuffers_.end(); ++tit)
+    {
+        if (!tit->second->isEmpty())
+            return false;
+    }
+
+    HarqRxBuffers::iterator rit;
+    for (rit = harqRxBuffers_.begin(); rit != harqRxBuffers_.end(); ++rit)
+    {
+        if (!rit->second->isEmpty())
+            return false;
+    }
+    return true;
+}
+
+void LteMacUe::enterDormancy()
+{
+    // when checking the dormant state, the UE keeps ticking while dormant
+    if (dormant_)
+        return;
+
+    EV << NOW << " LteMacUe::enterDormancy - UE " << nodeId_ << " is idle, stopping the TTI tick" << endl;
+
+    dormant_ = true;
+    dormantSince_ = NOW;
+    skippedTtis_ = 0;
+    if (checkIdleFastPath_)
+    {
+        dormantHarq_ = currentHarq_;
+        return;
+    }
+
+    if (ttiTick_->isScheduled())
+        cancelEvent(ttiTick_);
+
+    if (fbGen_ != NULL)
+        fbGen_->setDormant(true);
+}
+
+void LteMacUe::wakeUp(bool fromLowerLayer)
+{
+    if (!dormant_)
+        return;
+    dormant_ = false;
+
+    // TTIs elapsed since the last processed one. If a TTI starts now, the TTI tick (priority 1) comes
+    // after the messages from the RLC (priority 0), but before the ones the PHY sends while handling an
+    // air frame (priority 10): for the latter, the TTI starting now has already been processed
+    simtime_t nextTick = SIMTIME_ZERO;
+    if (!binder_->isGlobalTtiClock())
+    {
+        int64_t elapsed = (NOW - dormantSince_).raw();
+        int64_t period = SimTime(TTI).raw();
+        int64_t nextTti = fromLowerLayer ? elapsed / period + 1 : std::max((int64_t)1, (elapsed + period - 1) / period);
+        skippedTtis_ = nextTti - 1;
+        nextTick = dormantSince_ + SimTime(TTI) * nextTti;
+        if (!checkIdleFastPath_)
+            scheduleAt(nextTick, ttiTick_);
+    }
+
+    EV << NOW << " LteMacUe::wakeUp - UE " << nodeId_ << " wakes up after " << skippedTtis_ << " skipped TTIs" << endl;
+
+    if (checkIdleFastPath_)
+    {
+        // the UE kept ticking: it must be where the dormant UE would resume
+        if (!binder_->isGlobalTtiClock() && nextTick != ttiTick_->getArrivalTime())
+            throw cRuntimeError("LteMacUe::wakeUp - UE %d resumes at %s, while the next TTI is at %s",
+                nodeId_, nextTick.str().c_str(), ttiTick_->getArrivalTime().str().c_str());
+        if ((dormantHarq_ + skippedTtis_) % harqProcesses_ != currentHarq_)
+            throw cRuntimeError("LteMacUe::wakeUp - UE %d resumes with H-ARQ process %d, while the current one is %d",
+                nodeId_, (int)((dormantHarq_ + skippedTtis_) % harqProcesses_), (int)currentHarq_);
+        dormantTtis_ += skippedTtis_;
+        skippedTtis_ = 0;
+        return;
+    }
+
+    // in idle TTIs, the only change in the state of the UE is the H-ARQ process counter
+    currentHarq_ = (currentHarq_ + skippedTtis_) % harqProcesses_;
+    dormantTtis_ += skippedTtis_;
+    skippedTtis_ = 0;
+
+    if (fbGen_ != NULL)
+        fbGen_->setDormant(false);
 }
 
 int LteMacUe::macSduRequest()
@@ -693,9 +843,8 @@ void LteMacUe::handleSelfMessage()
 
         // Message that triggers flushing of Tx H-ARQ buffers for all users
         // This way, flushing is performed after the (possible) reception of new MAC PDUs
-        cMessage* flushHarqMsg = new cMessage("flushHarqMsg");
-        flushHarqMsg->setSchedulingPriority(1);        // after other messages
-        scheduleAt(NOW, flushHarqMsg);
+        if (!flushHarqMsg_->isScheduled())
+            scheduleAt(NOW, flushHarqMsg_);
 
 //        // deleting non-periodic grant
 //        if (!schedulingGrant_->getPeriodic())
@@ -17,6 +17,7 @@
 class LteSchedulingGrant;
 class LteSchedulerUeUl;
 class LteBinder;
+class LteDlFeedbackGenerator;
 
 class LteMacUe : public LteMacBase
 {
@@ -59,6 +60,26 @@ class LteMacUe : public LteMacBase
     // BSR handling
     bool bsrTriggered_;
 
+    /*
+     * Idle fast path: while the UE has no data, no grant, no pending H-ARQ
+     * and no RAC procedure, the TTI tick is stopped (dormant state), until
+     * a packet from the upper or the lower layer wakes the UE up
+     */
+    bool idleFastPath_;
+    bool dormant_;
+    // time of the last TTI processed before entering the dormant state
+    omnetpp::simtime_t dormantSince_;
+    // TTIs skipped in the dormant state (only counted when run by the global TTI clock)
+    unsigned long skippedTtis_;
+    // total number of TTIs skipped in the dormant state
+    unsigned long dormantTtis_;
+    // if true, the tick is not stopped in the dormant state, and wake-ups are checked against it
+    bool checkIdleFastPath_;
+    // H-ARQ process when entering the dormant state (checkIdleFastPath only)
+    unsigned char dormantHarq_;
+    // notified when entering and leaving the dormant state, to adapt the CQI reporting rate
+    LteDlFeedbackGenerator* fbGen_;
+
     // statistics
     omnetpp::simsignal_t cqiDlSpmux0_;
     omnetpp::simsignal_t cqiDlSpmux1_;
@@ -92,6 +113,30 @@ class LteMacUe : public LteMacBase
      */
     virtual void handleMessage(omnetpp::cMessage *msg) override;
 
+    /**
+     * Statistics recording
+     */
+    virtual void finish() override;
+
+    /**
+     * Returns true if nothing would happen in the next TTI, apart from
+     * advancing the H-ARQ process counter
+     */
+    virtual bool isIdle();
+
+    /**
+     * Stops the TTI tick
+     */
+    void enterDormancy();
+
+    /**
+     * Restarts the TTI tick, aligned to the TTIs skipped in the dormant state
+     *
+     * @param fromLowerLayer true if woken up by a message from the PHY, which
+     * is received after the TTI tick of the same instant
+     */
+    void wakeUp(bool fromLowerLayer);
+
     /**
      * macSduRequest() sends a message to the RLC layer
      * requesting MAC SDUs (one for each CID),
@@ -163,6 +208,13 @@ class LteMacUe : public LteMacBase
     LteMacUe();
     virtual ~LteMacUe();
 
+    /**
+     * Called by the global TTI clock, does nothing in the dormant state
+     */
+    virtual void handleTti() override;
+
+    bool isDormant() const { return dormant_; }
+
     /*
      * Access scheduling grant
      */
@@ -383,6 +383,9 @@ void LteMacUeD2D::handleMessage(cMessage* msg)
         return;
     }
 
+    // mode switch notifications are not handled by LteMacUe, hence wake up here
+    wakeUp(msg->getArrivalGate() == down_[IN]);
+
     cPacket* pkt = check_and_cast<cPacket *>(msg);
     cGate* incoming = pkt->getArrivalGate();
 
@@ -440,6 +443,13 @@ LteMacUeD2D::macHandleGrant(cPacket* pkt)
     racD2DMulticastRequested_=false;
 }
 
+bool LteMacUeD2D::isIdle()
+{
+    if (racD2DMulticastRequested_ || bsrD2DMulticastTriggered_)
+        return false;
+    return LteMacUe::isIdle();
+}
+
 void LteMacUeD2D::checkRAC()
 {
     EV << NOW << " LteMacUeD2D::checkRAC , Ue  " << nodeId_ << ", racTimer : " << racBackoffTimer_ << " maxRacTryOuts : " << maxRacTryouts_
@@ -705,9 +715,8 @@ void LteMacUeD2D::handleSelfMessage()
 
         // Message that triggers flushing of Tx H-ARQ buffers for all users
         // This way, flushing is performed after the (possible) reception of new MAC PDUs
-        cMessage* flushHarqMsg = new cMessage("flushHarqMsg");
-        flushHarqMsg->setSchedulingPriority(1);        // after other messages
-        scheduleAt(NOW, flushHarqMsg);
+        if (!flushHarqMsg_->isScheduled())
+            scheduleAt(NOW, flushHarqMsg_);
     }
 
     //============================ DEBUG ==========================
@@ -60,6 +60,8 @@ class LteMacUeD2D : public LteMacUe
      */
     virtual void checkRAC() override;
 
+    virtual bool isIdle() override;
+
     /*
      * Receives and handles RAC responses
      */
@@ -24,9 +24,69 @@ void LteScheduler::setEnbScheduler(LteSchedulerEnb* eNbScheduler)
     eNbScheduler_ = eNbScheduler;
     direction_ = eNbScheduler_->direction_;
     mac_ = eNbScheduler_->mac_;
+    scoreCache_ = mac_->par("schedulerScoreCache");
     initializeGrants();
 }
 
+void LteScheduler::removeNodeScores(MacNodeId nodeId)
+{
+    std::map<std::pair<MacNodeId, Direction>, NodeScore>::iterator it = nodeScores_.lower_bound(std::make_pair(nodeId, (Direction)0));
+    while (it != nodeScores_.end() && it->first.first == nodeId)
+        nodeScores_.erase(it++);
+}
+
+const LteScheduler::NodeScore* LteScheduler::computeNodeScore(MacNodeId nodeId, Direction dir)
+{
+    LteAmc* amc = mac_->getAmc();
+    NodeScore& score = scoreCache_ ? nodeScores_[std::make_pair(nodeId, dir)] : nodeScore_;
+
+    bool valid = scoreCache_ && score.txParamsVersion == amc->getTxParamsVersion(nodeId);
+    if (!valid)
+    {
+        const UserTxParams& info = amc->computeTxParams(nodeId, dir);
+        score.bands.assign(info.readBands().begin(), info.readBands().end());
+        score.antennas.assign(info.readAntennaSet().begin(), info.readAntennaSet().end());
+        score.codewords = info.getLayers().size();
+        score.cqiNull = false;
+        for (unsigned int i = 0; i < score.codewords; i++)
+        {
+            if (info.readCqiVector()[i] == 0)
+                score.cqiNull = true;
+        }
+        score.txParamsVersion = amc->getTxParamsVersion(nodeId);
+    }
+
+    if (score.cqiNull)
+        return NULL;
+    //no more free cw
+    if (eNbScheduler_->allocatedCws(nodeId) == score.codewords)
+        return NULL;
+
+    // read the blocks currently available to the node.
+    // NOTE: bands are visited for the first antenna only, as the score has always been computed
+    availableRbs_.clear();
+    std::vector<Band>::const_iterator it = score.bands.begin(), et = score.bands.end();
+    std::vector<Remote>::const_iterator antennaIt = score.antennas.begin(), antennaEt = score.antennas.end();
+    for (; antennaIt != antennaEt; ++antennaIt)
+    {
+        for (; it != et; ++it)
+            availableRbs_.push_back(eNbScheduler_->readAvailableRbs(nodeId, *antennaIt, *it));
+    }
+    if (valid && availableRbs_ == score.availableRbs)
+        return &score;
+
+    // compute score based on total available bytes
+    score.availableRbs = availableRbs_;
+    score.availableBlocks = 0;
+    score.availableBytes = 0;
+    for (unsigned int k = 0; k < availableRbs_.size(); ++k)
+    {
+        score.availableBlocks += availableRbs_[k];
+        score.availableBytes += amc->computeBytesOnNRbs(nodeId, score.bands[k], score.availableBlocks, dir);
+    }
+    return &score;
+}
+
 
 unsigned int LteScheduler::requestGrant(MacCid cid, unsigned int bytes, bool& terminate, bool& active, bool& eligible , std::vector<BandLimit>* bandLim)
 {
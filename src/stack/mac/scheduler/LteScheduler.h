@@ -89,6 +89,44 @@ class LteScheduler
      */
     std::map<LteTrafficClass, int> grantSizeMap_;
 
+    /**
+     * Per-node part of the channel-aware scores (see LteMaxCi and LtePf), i.e. the blocks
+     * available to the node on its bands and the bytes they can carry.
+     * It does not depend on the connection, hence it is shared by all the CIDs of the node.
+     */
+    struct NodeScore
+    {
+        // LteAmc::getTxParamsVersion() of the node when the entry has been filled, 0 if never
+        unsigned long txParamsVersion;
+        // data taken from the tx params of the node
+        unsigned int codewords;
+        bool cqiNull;
+        std::vector<Band> bands;
+        std::vector<Remote> antennas;
+        // blocks available on each visited band when the bytes have been computed
+        std::vector<unsigned int> availableRbs;
+        unsigned int availableBlocks;
+        unsigned int availableBytes;
+
+        NodeScore() : txParamsVersion(0), codewords(0), cqiNull(false), availableBlocks(0), availableBytes(0) {}
+    };
+
+    /**
+     * If true, the node scores are kept across TTIs. Tx params are recomputed only when the
+     * AMC reports that they may have changed, and bytes only when the available blocks change
+     */
+    bool scoreCache_;
+    std::map<std::pair<MacNodeId, Direction>, NodeScore> nodeScores_;
+    // used in place of nodeScores_ when the cache is disabled
+    NodeScore nodeScore_;
+    std::vector<unsigned int> availableRbs_;
+
+    /**
+     * Returns the per-node part of the score, or NULL if the node cannot be scheduled
+     * (null CQI on some codeword, or all codewords already allocated in this TTI)
+     */
+    const NodeScore* computeNodeScore(MacNodeId nodeId, Direction dir);
+
 //    CplexTest cplexTest_;
 
   public:
@@ -101,6 +139,7 @@ class LteScheduler
         //    WATCH(activeSet_);
         activeConnectionSet_.clear();
         binder_ = NULL;
+        scoreCache_ = false;
     }
     /**
      * Destructor.
@@ -159,6 +198,11 @@ class LteScheduler
     {
     }
 
+    /**
+     * Removes the cached scores of the given node (e.g. when it leaves the cell)
+     */
+    void removeNodeScores(MacNodeId nodeId);
+
     virtual void updateSchedulingInfo()
     {
     }
@@ -7,6 +7,9 @@
 // and cannot be removed from it.
 //
 
+#include <algorithm>
+#include <chrono>
+
 #include "stack/mac/scheduler/LteSchedulerEnb.h"
 #include "stack/mac/allocator/LteAllocationModule.h"
 #include "stack/mac/allocator/LteAllocationModuleFrequencyReuse.h"
@@ -33,6 +36,8 @@ LteSchedulerEnb::LteSchedulerEnb()
     harqTxBuffers_ = 0;
     harqRxBuffers_ = 0;
     resourceBlocks_ = 0;
+    profiling_ = false;
+    scheduledGrants_ = 0;
 
     // ********************************
     //    sleepSize_ = 0;
@@ -80,12 +85,18 @@ void LteSchedulerEnb::initialize(Direction dir, LteMacEnb* mac)
     cellBlocksUtilizationUl_ = mac_->registerSignal("cellBlocksUtilizationUl");
     lteAvgServedBlocksDl_ = mac_->registerSignal("avgServedBlocksDl");
     lteAvgServedBlocksUl_ = mac_->registerSignal("avgServedBlocksUl");
+
+    profiling_ = mac_->par("schedulerProfiling");
 }
 
 LteMacScheduleList* LteSchedulerEnb::schedule()
 {
     EV << "LteSchedulerEnb::schedule performed by Node: " << mac_->getMacNodeId() << endl;
 
+    std::chrono::steady_clock::time_point start;
+    if (profiling_)
+        start = std::chrono::steady_clock::now();
+
     // clearing structures for new scheduling
     scheduleList_.clear();
     allocatedCws_.clear();
@@ -109,9 +120,42 @@ LteMacScheduleList* LteSchedulerEnb::schedule()
     // record assigned resource blocks statistics
     resourceBlockStatistics();
 
+    if (profiling_)
+    {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        scheduleDurations_.push_back(elapsed.count());
+        scheduledGrants_ += scheduleList_.size();
+    }
+
     return &scheduleList_;
 }
 
+void LteSchedulerEnb::recordProfiling()
+{
+    if (!profiling_ || scheduleDurations_.empty())
+        return;
+
+    std::string suffix = (direction_ == DL) ? "Dl" : "Ul";
+    unsigned int ttis = scheduleDurations_.size();
+
+    double total = 0;
+    for (unsigned int i = 0; i < ttis; i++)
+        total += scheduleDurations_[i];
+
+    // percentiles of the per-TTI scheduling time
+    std::vector<double>::iterator p50 = scheduleDurations_.begin() + (ttis - 1) / 2;
+    std::nth_element(scheduleDurations_.begin(), p50, scheduleDurations_.end());
+    double median = *p50;
+    std::vector<double>::iterator p99 = scheduleDurations_.begin() + (ttis - 1) * 99 / 100;
+    std::nth_element(scheduleDurations_.begin(), p99, scheduleDurations_.end());
+
+    mac_->recordScalar(("scheduledTtis" + suffix).c_str(), ttis);
+    mac_->recordScalar(("scheduledTtisPerSecond" + suffix).c_str(), (total > 0) ? ttis / total : 0.0);
+    mac_->recordScalar(("scheduleTimeMedian" + suffix).c_str(), median, "s");
+    mac_->recordScalar(("scheduleTimeP99" + suffix).c_str(), *p99, "s");
+    mac_->recordScalar(("scheduledGrantsPerTti" + suffix).c_str(), (double)scheduledGrants_ / ttis);
+}
+
 /*  COMPLETE:        scheduleGrant(cid,bytes,terminate,active,eligible,band_limit,antenna);
  *  ANTENNA UNAWARE: scheduleGrant(cid,bytes,terminate,active,eligible,band_limit);
  *  BAND UNAWARE:    scheduleGrant(cid,bytes,terminate,active,eligible);
@@ -678,4 +722,7 @@ void LteSchedulerEnb::removeActiveConnections(MacNodeId nodeId)
             scheduler_->removeActiveConnection(cid);
         }
     }
+
+    // drop the cached scores of the node
+    scheduler_->removeNodeScores(nodeId);
 }
@@ -111,6 +111,13 @@ class LteSchedulerEnb
     // pre-made BandLimit structure used when the no band limit is given to the scheduler
     std::vector<BandLimit> emptyBandLim_;
 
+    /// Profiling of the scheduling function (see the schedulerProfiling parameter of the MAC)
+    bool profiling_;
+    // wall-clock duration of each call to schedule() (s)
+    std::vector<double> scheduleDurations_;
+    // number of grants put in the schedule list over all the profiled TTIs
+    unsigned long scheduledGrants_;
+
   public:
 
     /**
@@ -136,6 +143,14 @@ class LteSchedulerEnb
      */
     virtual LteMacScheduleList* schedule();
 
+    /**
+     * Records the profiling results as scalars of the MAC module,
+     * i.e. scheduled TTIs per second of wall-clock time, median and
+     * 99th percentile of the per-TTI scheduling time and grants per TTI.
+     * Does nothing if profiling is disabled.
+     */
+    void recordProfiling();
+
     /**
      * Update the status of the scheduler. Called by the MAC.
      * The function calls the LteScheduler update().
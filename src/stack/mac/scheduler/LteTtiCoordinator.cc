@@ -0,0 +1,53 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/mac/scheduler/LteTtiCoordinator.h"
+#include "stack/mac/layer/LteMacEnb.h"
+
+using namespace omnetpp;
+
+LteTtiCoordinator::LteTtiCoordinator()
+{
+    lastTti_ = -1;
+}
+
+void LteTtiCoordinator::registerMac(MacNodeId nodeId, LteMacEnb* mac)
+{
+    for (unsigned int i = 0; i < macs_.size(); i++)
+    {
+        if (macs_[i].first == nodeId)
+            throw cRuntimeError("LteTtiCoordinator::registerMac - eNB %d already registered", nodeId);
+    }
+
+    macs_.push_back(std::make_pair(nodeId, mac));
+}
+
+void LteTtiCoordinator::unregisterMac(MacNodeId nodeId)
+{
+    for (unsigned int i = 0; i < macs_.size(); i++)
+    {
+        if (macs_[i].first == nodeId)
+        {
+            macs_.erase(macs_.begin() + i);
+            return;
+        }
+    }
+}
+
+void LteTtiCoordinator::runTti()
+{
+    if (lastTti_ == NOW)
+        return;
+    lastTti_ = NOW;
+
+    // scheduling phase: each eNB only works on its own state. The commit
+    // phase is run by each eNB on its own TTI tick
+    for (unsigned int i = 0; i < macs_.size(); i++)
+        macs_[i].second->scheduleTti();
+}
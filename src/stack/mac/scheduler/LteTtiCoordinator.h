@@ -0,0 +1,63 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTETTICOORDINATOR_H_
+#define _LTE_LTETTICOORDINATOR_H_
+
+#include <vector>
+
+#include "common/LteCommon.h"
+
+/// forward declarations
+class LteMacEnb;
+
+/**
+ * @class LteTtiCoordinator
+ *
+ * Groups the scheduling passes of all the eNBs for the same TTI.
+ *
+ * When coordinated scheduling is enabled in the LteBinder, the eNB MACs
+ * split their main loop in two phases:
+ *  - scheduling: each eNB extracts the received PDUs and runs its UL
+ *    and DL schedulers. The first tick of each TTI triggers runTti(),
+ *    which performs this phase for all the eNBs, in registration order;
+ *  - commit: each eNB, on its own TTI tick, sends the UL grants and
+ *    requests the DL SDUs to the RLC layer.
+ * The eNBs register in the order of their TTI ticks. The scheduling
+ * phase is run sequentially on the simulation thread: the schedulers log
+ * through EV, emit signals and draw random numbers, none of which may be
+ * done from a worker thread. The packets sent during the scheduling phase
+ * leave from the first tick of the TTI, so the event order is not the same
+ * as in the sequential path.
+ */
+class LteTtiCoordinator
+{
+    // registered eNB MACs, in registration order
+    std::vector<std::pair<MacNodeId, LteMacEnb*> > macs_;
+
+    // TTI of the last run
+    omnetpp::simtime_t lastTti_;
+
+  public:
+    LteTtiCoordinator();
+
+    void registerMac(MacNodeId nodeId, LteMacEnb* mac);
+
+    void unregisterMac(MacNodeId nodeId);
+
+    /**
+     * Runs the scheduling phase of all the registered eNBs, once per TTI.
+     * Further calls within the same TTI have no effect
+     */
+    void runTti();
+
+    unsigned int size() const { return macs_.size(); }
+};
+
+#endif
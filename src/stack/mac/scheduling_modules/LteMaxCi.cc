@@ -50,38 +50,12 @@ void LteMaxCi::prepareSchedule()
         else
             dir = DL;
 
-        // compute available blocks for the current user
-        const UserTxParams& info = eNbScheduler_->mac_->getAmc()->computeTxParams(nodeId,dir);
-        const std::set<Band>& bands = info.readBands();
-        std::set<Band>::const_iterator it = bands.begin(),et=bands.end();
-        unsigned int codeword=info.getLayers().size();
-        bool cqiNull=false;
-        for (unsigned int i=0;i<codeword;i++)
-        {
-            if (info.readCqiVector()[i]==0)
-            cqiNull=true;
-        }
-        if (cqiNull)
-        continue;
-        //no more free cw
-        if (eNbScheduler_->allocatedCws(nodeId)==codeword)
-        continue;
-
-        std::set<Remote>::iterator antennaIt = info.readAntennaSet().begin(), antennaEt=info.readAntennaSet().end();
-
-        // compute score based on total available bytes
-        unsigned int availableBlocks=0;
-        unsigned int availableBytes =0;
-        // for each antenna
-        for (;antennaIt!=antennaEt;++antennaIt)
-        {
-            // for each logical band
-            for (;it!=et;++it)
-            {
-                availableBlocks += eNbScheduler_->readAvailableRbs(nodeId,*antennaIt,*it);
-                availableBytes += eNbScheduler_->mac_->getAmc()->computeBytesOnNRbs(nodeId,*it, availableBlocks, dir);
-            }
-        }
+        // compute available blocks and bytes for the current user
+        const NodeScore* nodeScore = computeNodeScore(nodeId, dir);
+        if (nodeScore == NULL)
+            continue;
+        unsigned int availableBlocks = nodeScore->availableBlocks;
+        unsigned int availableBytes = nodeScore->availableBytes;
 
         blocks = availableBlocks;
         // current user bytes per slot
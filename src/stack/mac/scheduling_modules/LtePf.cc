@@ -53,50 +53,21 @@ void LtePf::prepareSchedule()
         else
             dir = DL;
 
-        // check if node is still a valid node in the simulation - might have been dynamically removed
-        if(getBinder()->getOmnetId(nodeId) == 0){
-            activeConnectionTempSet_.erase(cid);
-            EV << "CID " << cid << " of node "<< nodeId << " removed from active connection set - no OmnetId in Binder known.";
+        // compute available blocks and bytes for the current user
+        const NodeScore* nodeScore = computeNodeScore(nodeId, dir);
+        if (nodeScore == NULL)
             continue;
-        }
-
-        // compute available blocks for the current user
-        const UserTxParams& info = eNbScheduler_->mac_->getAmc()->computeTxParams(nodeId,dir);
-        const std::set<Band>& bands = info.readBands();
-        unsigned int codeword=info.getLayers().size();
-        if (eNbScheduler_->allocatedCws(nodeId)==codeword)
-        continue;
-        std::set<Band>::const_iterator it = bands.begin(),et=bands.end();
-
-        std::set<Remote>::iterator antennaIt = info.readAntennaSet().begin(), antennaEt=info.readAntennaSet().end();
-
-        bool cqiNull=false;
-        for (unsigned int i=0;i<codeword;i++)
-        {
-            if (info.readCqiVector()[i]==0)
-            cqiNull=true;
-        }
-        if (cqiNull)
-        continue;
-        // compute score based on total available bytes
-        unsigned int availableBlocks=0;
-        unsigned int availableBytes =0;
-        // for each antenna
-        for (;antennaIt!=antennaEt;++antennaIt)
-        {
-            // for each logical band
-            for (;it!=et;++it)
-            {
-                availableBlocks += eNbScheduler_->readAvailableRbs(nodeId,*antennaIt,*it);
-                availableBytes += eNbScheduler_->mac_->getAmc()->computeBytesOnNRbs(nodeId,*it, availableBlocks, dir);
-            }
-        }
+        unsigned int availableBlocks = nodeScore->availableBlocks;
+        unsigned int availableBytes = nodeScore->availableBytes;
 
         double s=.0;
 
-        if (pfRate_.find(cid)==pfRate_.end()) pfRate_[cid]=0;
-        if(pfRate_[cid] < scoreEpsilon_) s = 1.0 / scoreEpsilon_;
-        else if(availableBlocks > 0) s = ((availableBytes / availableBlocks) / pfRate_[cid]) + uniform(getEnvir()->getRNG(0),-scoreEpsilon_/2.0, scoreEpsilon_/2.0);
+        PfRate::iterator rt = pfRate_.find(cid);
+        if (rt == pfRate_.end())
+            rt = pfRate_.insert(std::make_pair(cid, 0.0)).first;
+        double pfRate = rt->second;
+        if(pfRate < scoreEpsilon_) s = 1.0 / scoreEpsilon_;
+        else if(availableBlocks > 0) s = ((availableBytes / availableBlocks) / pfRate) + uniform(getEnvir()->getRNG(0),-scoreEpsilon_/2.0, scoreEpsilon_/2.0);
         else s = 0.0;
         // Create a new score descriptor for the connection, where the score is equal to the ratio between bytes per slot and long term rate
         ScoreDesc desc(cid,s);
@@ -0,0 +1,69 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <cmath>
+#include <omnetpp.h>
+
+#include "stack/phy/ChannelModel/ExtCellInterferenceMap.h"
+
+using namespace omnetpp;
+
+ExtCellInterferenceMap::ExtCellInterferenceMap()
+{
+    resolution_ = 10.0;
+    samples_ = 0;
+    computed_ = 0;
+}
+
+void ExtCellInterferenceMap::setResolution(double resolution)
+{
+    if (resolution <= 0)
+        throw cRuntimeError("ExtCellInterferenceMap::setResolution - invalid resolution %f", resolution);
+
+    resolution_ = resolution;
+    layers_[0].clear();
+    layers_[1].clear();
+}
+
+unsigned long long ExtCellInterferenceMap::toKey(const inet::Coord& pos) const
+{
+    int x = (int)floor(pos.x / resolution_);
+    int y = (int)floor(pos.y / resolution_);
+
+    // x in the upper 32 bits, y in the lower ones
+    return ((unsigned long long)(unsigned int)x << 32) | (unsigned long long)(unsigned int)y;
+}
+
+const std::vector<double>* ExtCellInterferenceMap::sample(const inet::Coord& pos, bool los)
+{
+    samples_++;
+
+    const std::unordered_map<unsigned long long, std::vector<double> >& layer = layers_[los ? 1 : 0];
+    std::unordered_map<unsigned long long, std::vector<double> >::const_iterator it = layer.find(toKey(pos));
+    if (it == layer.end())
+        return NULL;
+    return &it->second;
+}
+
+inet::Coord ExtCellInterferenceMap::getPixelCenter(const inet::Coord& pos) const
+{
+    inet::Coord center = pos;
+    center.x = (floor(pos.x / resolution_) + 0.5) * resolution_;
+    center.y = (floor(pos.y / resolution_) + 0.5) * resolution_;
+    return center;
+}
+
+const std::vector<double>* ExtCellInterferenceMap::store(const inet::Coord& pos, bool los, const std::vector<double>& interference)
+{
+    computed_++;
+
+    std::vector<double>& pixel = layers_[los ? 1 : 0][toKey(pos)];
+    pixel = interference;
+    return &pixel;
+}
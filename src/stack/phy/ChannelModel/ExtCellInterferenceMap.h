@@ -0,0 +1,73 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_EXTCELLINTERFERENCEMAP_H_
+#define _LTE_EXTCELLINTERFERENCEMAP_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include <inet/common/geometry/common/Coord.h>
+
+/**
+ * Raster of the interference produced by the external cells.
+ *
+ * The x-y plane is divided into square pixels. Each pixel stores, for each
+ * band, the interference (mW) received at its center from all the external
+ * cells, weighted by their average band occupation (see ExtCell::getBandLoad()).
+ * LOS and NLOS receivers are stored as two separate layers.
+ *
+ * The map is hosted by the binder and shared by the channel models of all the
+ * receivers. Pixels are computed by the first channel model whose receiver falls
+ * within them, and then sampled in O(1) by everyone, so that the cost of the
+ * external cells does not depend on their number once the area around the
+ * receivers is known. The pixel side trades accuracy for memory and set-up time.
+ */
+class ExtCellInterferenceMap
+{
+    // side of a pixel (m)
+    double resolution_;
+
+    // pixels computed so far, indexed by their key. Index 0 is the NLOS layer, 1 the LOS one
+    std::unordered_map<unsigned long long, std::vector<double> > layers_[2];
+
+    // pixel statistics
+    unsigned long samples_;
+    unsigned long computed_;
+
+    unsigned long long toKey(const inet::Coord& pos) const;
+
+  public:
+    ExtCellInterferenceMap();
+
+    void setResolution(double resolution);
+    double getResolution() const { return resolution_; }
+
+    /**
+     * Returns the per-band interference of the pixel containing the given
+     * position, NULL if the pixel has not been computed yet
+     */
+    const std::vector<double>* sample(const inet::Coord& pos, bool los);
+
+    /**
+     * Returns the center of the pixel containing the given position, where
+     * the interference of the pixel must be computed
+     */
+    inet::Coord getPixelCenter(const inet::Coord& pos) const;
+
+    /**
+     * Stores the per-band interference of the pixel containing the given position
+     */
+    const std::vector<double>* store(const inet::Coord& pos, bool los, const std::vector<double>& interference);
+
+    unsigned long getSamples() const { return samples_; }
+    unsigned long getComputedPixels() const { return computed_; }
+};
+
+#endif
@@ -69,7 +69,16 @@ class LteChannelModel : public omnetpp::cSimpleModule
      * @param frame pointer to the packet
      * @param lteinfo pointer to the user control info
      */
-    virtual std::vector<double> getSINR(LteAirFrame *frame, UserControlInfo* lteInfo) = 0;
+    virtual std::vector<double> getSINR(LteAirFrame *frame, const UserControlInfo* lteInfo) = 0;
+    /*
+     * Compute snr for each band, i.e. the received signal over the noise floor without
+     * interference. It is a lightweight alternative to getSINR() for signal strength
+     * measurements (e.g. handover broadcasts)
+     *
+     * @param frame pointer to the packet
+     * @param lteinfo pointer to the user control info
+     */
+    virtual std::vector<double> getSNR(LteAirFrame *frame, const UserControlInfo* lteInfo) = 0;
     /*
      * Compute the error probability of the transmitted packet according to cqi used, txmode, and the received power
      * after that it throws a random number in order to check if this packet will be corrupted or not
@@ -92,6 +101,33 @@ class LteChannelModel : public omnetpp::cSimpleModule
     virtual std::vector<double> getSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo,MacNodeId peerUeId,inet::Coord peerUeCoord,MacNodeId enbId=0) = 0;
     virtual std::vector<double> getSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord,MacNodeId enbId,const std::vector<double>& rsrpVector) = 0;
 
+    /*
+     * Buffer-based variants of getSIR(), getSINR(), getRSRP_D2D() and getSINR_D2D().
+     * The result is written into the given vector, which is resized to the number of bands.
+     * Callers that keep the vector across frames avoid a heap allocation per computation.
+     * The default implementations simply copy the result of the vector-returning functions
+     */
+    virtual void computeSIR(LteAirFrame *frame, UserControlInfo* lteInfo, std::vector<double>& sir)
+    {
+        sir = getSIR(frame, lteInfo);
+    }
+    virtual void computeSINR(LteAirFrame *frame, const UserControlInfo* lteInfo, std::vector<double>& sinr)
+    {
+        sinr = getSINR(frame, lteInfo);
+    }
+    virtual void computeRSRP_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord, std::vector<double>& rsrp)
+    {
+        rsrp = getRSRP_D2D(frame, lteInfo_1, destId, destCoord);
+    }
+    virtual void computeSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo, MacNodeId peerUeId, inet::Coord peerUeCoord, MacNodeId enbId, std::vector<double>& sinr)
+    {
+        sinr = getSINR_D2D(frame, lteInfo, peerUeId, peerUeCoord, enbId);
+    }
+    virtual void computeSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord, MacNodeId enbId, const std::vector<double>& rsrpVector, std::vector<double>& sinr)
+    {
+        sinr = getSINR_D2D(frame, lteInfo_1, destId, destCoord, enbId, rsrpVector);
+    }
+
     virtual bool isUplinkInterferenceEnabled() { return false; }
     virtual bool isD2DInterferenceEnabled() { return false; }
 };
@@ -20,7 +20,7 @@ void LteDummyChannelModel::initialize()
 }
 
 
-std::vector<double> LteDummyChannelModel::getSINR(LteAirFrame *frame, UserControlInfo* lteInfo)
+std::vector<double> LteDummyChannelModel::getSINR(LteAirFrame *frame, const UserControlInfo* lteInfo)
 {
    std::vector<double> tmp;
    tmp.push_back(10000);
@@ -29,6 +29,11 @@ std::vector<double> LteDummyChannelModel::getSINR(LteAirFrame *frame, UserContro
    return tmp;
 }
 
+std::vector<double> LteDummyChannelModel::getSNR(LteAirFrame *frame, const UserControlInfo* lteInfo)
+{
+   return getSINR(frame, lteInfo);
+}
+
 std::vector<double> LteDummyChannelModel::getRSRP_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord)
 {
    std::vector<double> tmp;
@@ -58,7 +58,14 @@ class LteDummyChannelModel : public LteChannelModel
     * @param frame pointer to the packet
     * @param lteinfo pointer to the user control info
     */
-   virtual std::vector<double> getSINR(LteAirFrame *frame, UserControlInfo* lteInfo);
+   virtual std::vector<double> getSINR(LteAirFrame *frame, const UserControlInfo* lteInfo);
+   /*
+    * Compute snr for each band (same as getSINR in this model)
+    *
+    * @param frame pointer to the packet
+    * @param lteinfo pointer to the user control info
+    */
+   virtual std::vector<double> getSNR(LteAirFrame *frame, const UserControlInfo* lteInfo);
    /*
     * Compute the error probability of the transmitted packet according to cqi used, txmode, and the received power
     * after that it throws a random number in order to check if this packet will be corrupted or not
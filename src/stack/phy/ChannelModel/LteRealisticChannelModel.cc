@@ -73,8 +73,30 @@ void LteRealisticChannelModel::initialize()
    enableD2DInterference_ = par("d2d_interference");
    delayRMS_ = par("delay_rms");
 
+   batchedFading_ = par("batched_fading");
+
+   lazySinr_ = par("lazySinr");
+   skippedSinrBands_ = 0;
+   WATCH(skippedSinrBands_);
+
+   enableAttenuationCache_ = par("attenuationCache");
+   attenuationCacheHits_ = 0;
+   attenuationCacheMisses_ = 0;
+   WATCH(attenuationCacheHits_);
+   WATCH(attenuationCacheMisses_);
+
+   sinrAllocations_ = 0;
+   sinrAllocationsTti_ = 0;
+   maxSinrAllocationsTti_ = 0;
+   lastSinrAllocation_ = -1;
+   WATCH(sinrAllocations_);
+   WATCH(sinrAllocationsTti_);
+
    //get binder
    binder_ = getBinder();
+
+   useExtCellInterferenceMap_ = binder_->isExtCellInterferenceMap();
+   extCellInterferenceMap_ = useExtCellInterferenceMap_ ? binder_->getExtCellInterferenceMap() : NULL;
    //clear jakes fading map structure
    jakesFadingMap_.clear();
 
@@ -82,9 +104,97 @@ void LteRealisticChannelModel::initialize()
    rcvdSinr_ = registerSignal("rcvdSinr");
 }
 
+void LteRealisticChannelModel::finish()
+{
+   if (enableAttenuationCache_)
+   {
+       recordScalar("attenuationCacheHits", attenuationCacheHits_);
+       recordScalar("attenuationCacheMisses", attenuationCacheMisses_);
+   }
+   recordScalar("sinrAllocations", sinrAllocations_);
+   recordScalar("maxSinrAllocationsPerTti", maxSinrAllocationsTti_);
+   recordScalar("lastSinrAllocation", lastSinrAllocation_);
+   if (lazySinr_)
+       recordScalar("skippedSinrBands", skippedSinrBands_);
+}
+
+void LteRealisticChannelModel::prepareBuffer(std::vector<double>& buffer, double value)
+{
+   if (buffer.capacity() < band_)
+   {
+       if (lastSinrAllocation_ != NOW)
+       {
+           lastSinrAllocation_ = NOW;
+           sinrAllocationsTti_ = 0;
+       }
+       sinrAllocations_++;
+       sinrAllocationsTti_++;
+       if (sinrAllocationsTti_ > maxSinrAllocationsTti_)
+           maxSinrAllocationsTti_ = sinrAllocationsTti_;
+   }
+   buffer.assign(band_, value);
+}
 
 double LteRealisticChannelModel::getAttenuation(MacNodeId nodeId, Direction dir,
        Coord coord)
+{
+   if (!enableAttenuationCache_)
+       return computeAttenuation(nodeId, dir, coord);
+
+   // the eNB is either the owner of this channel model or the serving cell of the UE
+   MacNodeId enbId = phy_->getMacNodeId();
+   if (getNodeTypeById(enbId) != ENODEB)
+       enbId = binder_->getNextHop(nodeId);
+
+   return getAttenuation(nodeId, dir, coord, enbId);
+}
+
+double LteRealisticChannelModel::getAttenuation(MacNodeId nodeId, Direction dir,
+       Coord coord, MacNodeId enbId)
+{
+   if (!enableAttenuationCache_)
+       return computeAttenuation(nodeId, dir, coord);
+
+   if (attenuationCache_.size() <= nodeId)
+       attenuationCache_.resize(nodeId + 1);
+   AttenuationCacheSlot& slot = attenuationCache_[nodeId];
+
+   // a new TTI started, previous values are no longer valid
+   if (slot.epoch != NOW)
+   {
+       slot.entries.clear();
+       slot.epoch = NOW;
+   }
+
+   for (unsigned int i = 0; i < slot.entries.size(); i++)
+   {
+       const AttenuationCacheEntry& entry = slot.entries[i];
+       if (entry.enbId == enbId && entry.dir == dir && entry.coord == coord)
+       {
+           attenuationCacheHits_++;
+           EV << "LteRealisticChannelModel::getAttenuation - cached attenuation for node " << nodeId << " is " << entry.attenuation << endl;
+           return entry.attenuation;
+       }
+   }
+
+   attenuationCacheMisses_++;
+   AttenuationCacheEntry entry;
+   entry.enbId = enbId;
+   entry.dir = dir;
+   entry.coord = coord;
+   entry.attenuation = computeAttenuation(nodeId, dir, coord);
+   slot.entries.push_back(entry);
+   return entry.attenuation;
+}
+
+void LteRealisticChannelModel::invalidateAttenuationCache(MacNodeId nodeId)
+{
+   if (nodeId < attenuationCache_.size())
+       attenuationCache_[nodeId].entries.clear();
+}
+
+double LteRealisticChannelModel::computeAttenuation(MacNodeId nodeId, Direction dir,
+       Coord coord)
 {
    double movement = .0;
    double speed = .0;
@@ -204,6 +314,7 @@ double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction
        || losMap_.find(nodeId) == losMap_.end())
    {
        computeLosProbability(sqrDistance, nodeId);
+       invalidateAttenuationCache(nodeId);
    }
 
    //compute attenuation based on selected scenario and based on LOS or NLOS
@@ -238,6 +349,7 @@ double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction
            //store the shadowing attenuation for this user and the temporal mark
            std::pair<simtime_t, double> tmp(NOW, att);
            lastComputedSF_[nodeId] = tmp;
+           invalidateAttenuationCache(nodeId);
 
            //If the shadowing attenuation has been computed at least one time for this user
            // and the distance traveled by the UE is greated than correlation distance
@@ -263,6 +375,7 @@ double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction
            // Store the new computed shadowing
            std::pair<simtime_t, double> tmp(NOW, att);
            lastComputedSF_[nodeId] = tmp;
+           invalidateAttenuationCache(nodeId);
 
            // if the distance traveled by the UE is smaller than correlation distance shadowing attenuation remain the same
        }
@@ -382,13 +495,20 @@ double computeAngolarAttenuation(double angle) {
 
    return angolarAtt;
 }
-std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserControlInfo* lteInfo)
+std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, const UserControlInfo* lteInfo)
+{
+   std::vector<double> snrVector;
+   computeSINR(frame, lteInfo, snrVector);
+   return snrVector;
+}
+
+void LteRealisticChannelModel::computeSINR(LteAirFrame *frame, const UserControlInfo* lteInfo, std::vector<double>& snrVector)
 {
    //get tx power
    double recvPower = lteInfo->getTxPower(); // dBm
 
    //Get the Resource Blocks used to transmit this packet
-   RbMap rbmap = lteInfo->getGrantedBlocks();
+   const RbMap& rbmap = lteInfo->getGrantedBlocks();
 
    //get move object associated to the packet
    //this object is refereed to eNodeB if direction is DL or UE if direction is UL
@@ -427,8 +547,9 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
        antennaGainTx = antennaGainEnB_; //dB
        antennaGainRx = antennaGainUe_;  //dB
 
-       // get MacId for Ue and eNb
-       ueId = lteInfo->getDestId();
+       // get MacId for Ue and eNb. Handover broadcasts are shared among all the
+       // receivers, hence they are not addressed to this UE
+       ueId = (lteInfo->getFrameType() == HANDOVERPKT) ? phy_->getMacNodeId() : lteInfo->getDestId();
        eNbId = lteInfo->getSourceId();
 
        // get position of Ue and eNb
@@ -500,9 +621,9 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
    // attenuation for the desired signal
    double attenuation;
    if ((lteInfo->getFrameType() == FEEDBACKPKT))
-       attenuation = getAttenuation(ueId, UL, coord); // dB
+       attenuation = getAttenuation(ueId, UL, coord, eNbId); // dB
    else
-       attenuation = getAttenuation(ueId, dir, coord); // dB
+       attenuation = getAttenuation(ueId, dir, coord, eNbId); // dB
 
    //compute attenuation (PATHLOSS + SHADOWING)
    recvPower -= attenuation; // (dBm-dB)=dBm
@@ -518,10 +639,7 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
    if (dir == DL)
    {
        //get tx angle
-       omnetpp::cModule* eNbModule = getSimulation()->getModule(binder_->getOmnetId(eNbId));
-       LtePhyBase* ltePhy = eNbModule ?
-          check_and_cast<LtePhyBase*>(eNbModule->getSubmodule("lteNic")->getSubmodule("phy")) :
-          nullptr;
+       LtePhyBase* ltePhy = binder_->getPhyByMacNodeId(eNbId);
 
        if (ltePhy && ltePhy->getTxDirection() == ANISOTROPIC)
        {
@@ -546,8 +664,7 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
    }
    //=============== END ANGOLAR ATTENUATION =================
 
-   std::vector<double> snrVector;
-   snrVector.resize(band_, 0.0);
+   prepareBuffer(snrVector);
 
    // compute and add interference due to fading
    // Apply fading for each band
@@ -555,16 +672,30 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
    // if the phy layer is distributed the number of logical band should be set to 1
    double fadingAttenuation = 0;
 
+   // in lazy mode, data frames are evaluated on the granted bands only
+   bool lazy = lazySinr_ && lteInfo->getFrameType() == DATAPKT;
+
+   if (batchedFading_ && !lazy)
+       computeFadingVector(ueId, speed, cqiDl);
+
    // for each logical band
-   // FIXME compute fading only for used RBs
    for (unsigned int i = 0; i < band_; i++)
    {
+       if (lazy && !rbmap.isBandUsed(i))
+       {
+           skippedSinrBands_++;
+           continue;
+       }
+
        fadingAttenuation = 0;
        //if fading is enabled
        if (fading_)
        {
+           if (batchedFading_ && !lazy)
+               fadingAttenuation = fadingVector_[i];
+
            //Appling fading
-           if (fadingType_ == RAYLEIGH)
+           else if (fadingType_ == RAYLEIGH)
                fadingAttenuation = rayleighFading(ueId, i);
 
            else if (fadingType_ == JAKES)
@@ -609,9 +740,9 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
 
    //============ MULTI CELL INTERFERENCE COMPUTATION =================
    //vector containing the sum of multicell interference for each band
-   std::vector<double> multiCellInterference; // Linear value (mW)
+   std::vector<double>& multiCellInterference = multiCellInterference_; // Linear value (mW)
    // prepare data structure
-   multiCellInterference.resize(band_, 0);
+   prepareBuffer(multiCellInterference);
    if (enableDownlinkInterference_ && dir == DL)
    {
        computeDownlinkInterference(eNbId, ueId, ueCoord, (lteInfo->getFrameType() == FEEDBACKPKT), rbmap, &multiCellInterference);
@@ -623,12 +754,12 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
 
    //============ EXTCELL INTERFERENCE COMPUTATION =================
    //vector containing the sum of ext-cell interference for each band
-   std::vector<double> extCellInterference; // Linear value (mW)
+   std::vector<double>& extCellInterference = extCellInterference_; // Linear value (mW)
    // prepare data structure
-   extCellInterference.resize(band_, 0);
+   prepareBuffer(extCellInterference);
    if (enableExtCellInterference_ && dir == DL)
    {
-       computeExtCellInterference(eNbId, ueId, ueCoord, (lteInfo->getFrameType() == FEEDBACKPKT), &extCellInterference); // dBm
+       computeExtCellInterference(eNbId, ueId, ueCoord, (lteInfo->getFrameType() == FEEDBACKPKT), &extCellInterference, lazy ? &rbmap : NULL); // dBm
    }
 
    //===================== SINR COMPUTATION ========================
@@ -644,7 +775,7 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
    {
        // if we are decoding a data transmission and this RB has not been used, skip it
        // TODO fix for multi-antenna case
-       if (lteInfo->getFrameType() == DATAPKT && rbmap[MACRO][i] == 0)
+       if (lteInfo->getFrameType() == DATAPKT && rbmap.get(MACRO, i) == 0)
            continue;
 
        //               (      mW            +  mW  +        mW            )
@@ -664,10 +795,86 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
    //sender is an UE
    else
        updatePositionHistory(ueId, coord);
+}
+
+std::vector<double> LteRealisticChannelModel::getSNR(LteAirFrame *frame, const UserControlInfo* lteInfo)
+{
+   // this is only used for DL frames received by the UE (e.g. handover broadcasts),
+   // hence the parameters are the same as in the DL branch of getSINR()
+   if (lteInfo->getDirection() != DL || lteInfo->getFrameType() == FEEDBACKPKT)
+       throw cRuntimeError("LteRealisticChannelModel::getSNR - only DL non-feedback frames are supported");
+
+   double recvPower = lteInfo->getTxPower(); // dBm
+
+   MacNodeId ueId = (lteInfo->getFrameType() == HANDOVERPKT) ? phy_->getMacNodeId() : lteInfo->getDestId();
+   MacNodeId eNbId = lteInfo->getSourceId();
+   Coord ueCoord = phy_->getCoord();
+   Coord enbCoord = lteInfo->getCoord();
+   double speed = computeSpeed(ueId, ueCoord);
+
+   EV << "------------ GET SNR ----------------" << endl;
+
+   //=============== PATH LOSS + SHADOWING =================
+   double attenuation = getAttenuation(ueId, DL, enbCoord, eNbId); // dB
+   recvPower -= attenuation;
+   recvPower += antennaGainEnB_;
+   recvPower += antennaGainUe_;
+   recvPower -= cableLoss_;
+
+   //=============== ANGOLAR ATTENUATION =================
+   LtePhyBase* ltePhy = binder_->getPhyByMacNodeId(eNbId);
+
+   if (ltePhy && ltePhy->getTxDirection() == ANISOTROPIC)
+   {
+       double recvAngle = fabs(ltePhy->getTxAngle() - computeAngle(enbCoord, ueCoord));
+       if (recvAngle > 180)
+           recvAngle = 360 - recvAngle;
+       recvPower -= computeAngolarAttenuation(recvAngle);
+   }
+
+   //=============== FADING AND NOISE =================
+   std::vector<double> snrVector;
+   snrVector.resize(band_, 0.0);
+
+   if (fading_ && batchedFading_)
+       computeFadingVector(ueId, speed, false);
+
+   double noise = thermalNoise_ + ueNoiseFigure_; // dBm
+   for (unsigned int i = 0; i < band_; i++)
+   {
+       double fadingAttenuation = 0;
+       if (fading_)
+       {
+           if (batchedFading_)
+               fadingAttenuation = fadingVector_[i];
+           else if (fadingType_ == RAYLEIGH)
+               fadingAttenuation = rayleighFading(ueId, i);
+           else if (fadingType_ == JAKES)
+               fadingAttenuation = jakesFading(ueId, speed, i, false);
+       }
+
+       double finalRecvPower = recvPower + fadingAttenuation;
+       if (lteInfo->getTxMode() == MULTI_USER)
+           finalRecvPower -= 3;
+
+       snrVector[i] = finalRecvPower - noise;
+   }
+
+   EV << "LteRealisticChannelModel::getSNR - srcId=" << eNbId << " - destId=" << ueId
+      << " - attenuation=" << attenuation << " - distance=" << enbCoord.distance(ueCoord) << endl;
+
+   updatePositionHistory(ueId, ueCoord);
    return snrVector;
 }
 
 std::vector<double> LteRealisticChannelModel::getRSRP_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, Coord destCoord)
+{
+   std::vector<double> rsrpVector;
+   computeRSRP_D2D(frame, lteInfo_1, destId, destCoord, rsrpVector);
+   return rsrpVector;
+}
+
+void LteRealisticChannelModel::computeRSRP_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, Coord destCoord, std::vector<double>& rsrpVector)
 {
    // AttenuationVector::iterator it;
    // Get Tx power
@@ -682,7 +889,7 @@ std::vector<double> LteRealisticChannelModel::getRSRP_D2D(LteAirFrame *frame, Us
    double speed = 0.0;
    // Get MacId for Ue and his peer
    MacNodeId sourceId = lteInfo_1->getSourceId();
-   std::vector<double> rsrpVector;
+   prepareBuffer(rsrpVector);
 
    // True if we use the jakes map in the UE side (D2D is like DL for the receivers)
    bool cqiDl = false;
@@ -744,6 +951,9 @@ std::vector<double> LteRealisticChannelModel::getRSRP_D2D(LteAirFrame *frame, Us
    // if the phy layer is localized we can assume that for each logical band we have different fading attenuation
    // if the phy layer is distributed the number of logical band should be set to 1
    double fadingAttenuation = 0;
+   if (batchedFading_)
+       computeFadingVector(sourceId, speed, cqiDl);
+
    //for each logical band
    for (unsigned int i = 0; i < band_; i++)
    {
@@ -751,8 +961,11 @@ std::vector<double> LteRealisticChannelModel::getRSRP_D2D(LteAirFrame *frame, Us
        //if fading is enabled
        if (fading_)
        {
+           if (batchedFading_)
+               fadingAttenuation = fadingVector_[i];
+
            //Appling fading
-           if (fadingType_ == RAYLEIGH)
+           else if (fadingType_ == RAYLEIGH)
                fadingAttenuation = rayleighFading(sourceId, i);
 
            else if (fadingType_ == JAKES)
@@ -783,21 +996,26 @@ std::vector<double> LteRealisticChannelModel::getRSRP_D2D(LteAirFrame *frame, Us
           << " fading attenuation " << fadingAttenuation << endl;
 
        // Store the calculated receive power
-       rsrpVector.push_back(finalRecvPower);
+       rsrpVector[i] = finalRecvPower;
    }
    //============ END PATH LOSS + SHADOWING + FADING ===============
-
-   return rsrpVector;
 }
 
 std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo, MacNodeId destId, Coord destCoord, MacNodeId enbId)
+{
+   std::vector<double> snrVector;
+   computeSINR_D2D(frame, lteInfo, destId, destCoord, enbId, snrVector);
+   return snrVector;
+}
+
+void LteRealisticChannelModel::computeSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo, MacNodeId destId, Coord destCoord, MacNodeId enbId, std::vector<double>& snrVector)
 {
    // AttenuationVector::iterator it;
    // Get Tx power
    double recvPower = lteInfo->getD2dTxPower(); // dBm
 
    // Get allocated RBs
-   RbMap rbmap = lteInfo->getGrantedBlocks();
+   const RbMap& rbmap = lteInfo->getGrantedBlocks();
 
    // Coordinate of the Sender of the Feedback packet
    Coord sourceCoord =  lteInfo->getCoord();
@@ -809,8 +1027,7 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
    double extCellInterference = 0;
    // Get MacId for Ue and his peer
    MacNodeId sourceId = lteInfo->getSourceId();
-   std::vector<double> snrVector;
-   snrVector.resize(band_, 0.0);
+   prepareBuffer(snrVector);
 
    // True if we use the jakes map in the UE side (D2D is like DL for the receivers)
    bool cqiDl = true;
@@ -862,15 +1079,31 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
    // if the phy layer is localized we can assume that for each logical band we have different fading attenuation
    // if the phy layer is distributed the number of logical band should be set to 1
    double fadingAttenuation = 0;
+
+   // in lazy mode, data frames are evaluated on the granted bands only
+   bool lazy = lazySinr_ && lteInfo->getFrameType() == DATAPKT;
+
+   if (batchedFading_ && !lazy)
+       computeFadingVector(sourceId, speed, cqiDl);
+
    //for each logical band
    for (unsigned int i = 0; i < band_; i++)
    {
+       if (lazy && !rbmap.isBandUsed(i))
+       {
+           skippedSinrBands_++;
+           continue;
+       }
+
        fadingAttenuation = 0;
        //if fading is enabled
        if (fading_)
        {
+           if (batchedFading_ && !lazy)
+               fadingAttenuation = fadingVector_[i];
+
            //Appling fading
-           if (fadingType_ == RAYLEIGH)
+           else if (fadingType_ == RAYLEIGH)
                fadingAttenuation = rayleighFading(sourceId, i);
 
            else if (fadingType_ == JAKES)
@@ -926,9 +1159,9 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
     * is so we swap the ueId with the one of his Peer(D2D_Rx). We do the same for the coord.
     */
    //vector containing the sum of inCell interference for each band
-   std::vector<double> d2dInterference; // Linear value (mW)
+   std::vector<double>& d2dInterference = d2dInterference_; // Linear value (mW)
    // prepare data structure
-   d2dInterference.resize(band_, 0);
+   prepareBuffer(d2dInterference);
    if (enableD2DInterference_)
    {
        computeD2DInterference(enbId, sourceId, sourceCoord, destId, destCoord, (lteInfo->getFrameType() == FEEDBACKPKT), rbmap, &d2dInterference,dir);
@@ -949,7 +1182,7 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
            {
                // if we are decoding a data transmission and this RB has not been used, skip it
                // TODO fix for multi-antenna case
-               if (lteInfo->getFrameType() == DATAPKT && rbmap[MACRO][i] == 0)
+               if (lteInfo->getFrameType() == DATAPKT && rbmap.get(MACRO, i) == 0)
                    continue;
 
                //               (      mW            +  mW  +        mW            )
@@ -969,7 +1202,7 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
        {
            // if we are decoding a data transmission and this RB has not been used, skip it
            // TODO fix for multi-antenna case
-           if (lteInfo->getFrameType() == DATAPKT && rbmap[MACRO][i] == 0)
+           if (lteInfo->getFrameType() == DATAPKT && rbmap.get(MACRO, i) == 0)
                continue;
 
            /*
@@ -985,19 +1218,29 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
    }
    //sender is an UE
    updatePositionHistory(sourceId, sourceCoord);
+}
 
+std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, Coord destCoord,MacNodeId enbId,const std::vector<double>& rsrpVector)
+{
+   std::vector<double> snrVector;
+   computeSINR_D2D(frame, lteInfo_1, destId, destCoord, enbId, rsrpVector, snrVector);
    return snrVector;
 }
 
-std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, Coord destCoord,MacNodeId enbId,const std::vector<double>& rsrpVector)
+void LteRealisticChannelModel::computeSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, Coord destCoord, MacNodeId enbId, const std::vector<double>& rsrpVector, std::vector<double>& snrVector)
 {
-   std::vector<double> snrVector = rsrpVector;
+   // the SINR is computed in place, starting from the received power
+   if (&snrVector != &rsrpVector)
+   {
+       prepareBuffer(snrVector);
+       snrVector.assign(rsrpVector.begin(), rsrpVector.end());
+   }
 
    MacNodeId sourceId = lteInfo_1->getSourceId();
    Coord sourceCoord = lteInfo_1->getCoord();
 
    // Get allocated RBs
-   RbMap rbmap = lteInfo_1->getGrantedBlocks();
+   const RbMap& rbmap = lteInfo_1->getGrantedBlocks();
 
    // Get the direction
    Direction dir = D2D;
@@ -1032,9 +1275,9 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
     * is so we swap the ueId with the one of his Peer(D2D_Rx). We do the same for the coord.
     */
    //vector containing the sum of inCell interference for each band
-   std::vector<double> d2dInterference; // Linear value (mW)
+   std::vector<double>& d2dInterference = d2dInterference_; // Linear value (mW)
    // prepare data structure
-   d2dInterference.resize(band_, 0);
+   prepareBuffer(d2dInterference);
    if (enableD2DInterference_)
    {
        computeD2DInterference(enbId, sourceId, sourceCoord, destId, destCoord, (lteInfo_1->getFrameType() == FEEDBACKPKT), rbmap, &d2dInterference,dir);
@@ -1055,7 +1298,7 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
            {
                // if we are decoding a data transmission and this RB has not been used, skip it
                // TODO fix for multi-antenna case
-               if (lteInfo_1->getFrameType() == DATAPKT && rbmap[MACRO][i] == 0)
+               if (lteInfo_1->getFrameType() == DATAPKT && rbmap.get(MACRO, i) == 0)
                    continue;
 
                //               (      mW            +  mW  +        mW            )
@@ -1075,7 +1318,7 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
        {
            // if we are decoding a data transmission and this RB has not been used, skip it
            // TODO fix for multi-antenna case
-           if (lteInfo_1->getFrameType() == DATAPKT && rbmap[MACRO][i] == 0)
+           if (lteInfo_1->getFrameType() == DATAPKT && rbmap.get(MACRO, i) == 0)
                continue;
 
            // compute final SINR
@@ -1087,13 +1330,19 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
 
    //sender is a UE
    updatePositionHistory(sourceId, sourceCoord);
-
-   return snrVector;
 }
 
 
 std::vector<double> LteRealisticChannelModel::getSIR(LteAirFrame *frame,
        UserControlInfo* lteInfo)
+{
+   std::vector<double> snrVector;
+   computeSIR(frame, lteInfo, snrVector);
+   return snrVector;
+}
+
+void LteRealisticChannelModel::computeSIR(LteAirFrame *frame,
+       UserControlInfo* lteInfo, std::vector<double>& snrVector)
 {
    // AttenuationVector::iterator it;
    //get tx power
@@ -1129,9 +1378,12 @@ std::vector<double> LteRealisticChannelModel::getSIR(LteAirFrame *frame,
    //Apply fading for each band
    //if the phy layer is localized we can assume that for each logical band we have different fading attenuation
    //if the phy layer is distributed the number of logical band should be set to 1
-   std::vector<double> snrVector;
+   prepareBuffer(snrVector);
 
    double fadingAttenuation = 0;
+   if (batchedFading_)
+       computeFadingVector(id, speed, dir);
+
    //for each logical band
    for (unsigned int i = 0; i < band_; i++)
    {
@@ -1139,8 +1391,12 @@ std::vector<double> LteRealisticChannelModel::getSIR(LteAirFrame *frame,
        //if fading is enabled
        if (fading_)
        {
+           if (batchedFading_)
+           {
+               fadingAttenuation = fadingVector_[i];
+           }
            //Applying fading
-           if (fadingType_ == RAYLEIGH)
+           else if (fadingType_ == RAYLEIGH)
            {
                fadingAttenuation = rayleighFading(id, i);
            }
@@ -1157,7 +1413,7 @@ std::vector<double> LteRealisticChannelModel::getSIR(LteAirFrame *frame,
        if (lteInfo->getTxMode() == MULTI_USER)
            finalSnr -= 3;
 
-       snrVector.push_back(finalSnr);
+       snrVector[i] = finalSnr;
    }
 
    //if sender is a eNodeB
@@ -1167,7 +1423,6 @@ std::vector<double> LteRealisticChannelModel::getSIR(LteAirFrame *frame,
    //sender is an UE
    else
        updatePositionHistory(id, coord);
-   return snrVector;
 }
 
 double LteRealisticChannelModel::rayleighFading(MacNodeId id,
@@ -1179,6 +1434,33 @@ double LteRealisticChannelModel::rayleighFading(MacNodeId id,
    return linearToDb(temp1);
 }
 
+LteRealisticChannelModel::JakesFadingData& LteRealisticChannelModel::getJakesFadingData(JakesFadingMap* actualJakesMap, MacNodeId nodeId)
+{
+   JakesFadingMap::iterator it = actualJakesMap->find(nodeId);
+   if (it != actualJakesMap->end())
+       return it->second;
+
+   //this is the first time that we compute fading for current user
+   JakesFadingData& data = (*actualJakesMap)[nodeId];
+   data.angleOfArrival.reserve(band_ * fadingPaths_);
+   data.delaySpread.reserve(band_ * fadingPaths_);
+
+   //for each band we are going to create a jakes fading
+   for (unsigned int j = 0; j < band_; j++)
+   {
+       //for each fading path
+       for (int i = 0; i < fadingPaths_; i++)
+       {
+           //get angle of arrivals
+           data.angleOfArrival.push_back(cos(uniform(0, M_PI)));
+
+           //get delay spread (rounded to the simtime resolution, as it used to be stored as simtime_t)
+           data.delaySpread.push_back(simtime_t(exponential(delayRMS_)).dbl());
+       }
+   }
+   return data;
+}
+
 double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
        unsigned int band, bool cqiDl)
 {
@@ -1201,34 +1483,10 @@ double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
    else
        actualJakesMap = &jakesFadingMap_;
 
-   //if this is the first time that we compute fading for current user
-   if (actualJakesMap->find(nodeId) == actualJakesMap->end())
-   {
-       //clear the map
-       // FIXME: possible memory leak
-       (*actualJakesMap)[nodeId].clear();
-
-       //for each band we are going to create a jakes fading
-       for (unsigned int j = 0; j < band_; j++)
-       {
-           //clear some structure
-           JakesFadingData temp;
-           temp.angleOfArrival.clear();
-           temp.delaySpread.clear();
-
-           //for each fading path
-           for (int i = 0; i < fadingPaths_; i++)
-           {
-               //get angle of arrivals
-               temp.angleOfArrival.push_back(cos(uniform(0, M_PI)));
+   const JakesFadingData& data = getJakesFadingData(actualJakesMap, nodeId);
+   const double* angleOfArrival = &data.angleOfArrival[band * fadingPaths_];
+   const double* delaySpread = &data.delaySpread[band * fadingPaths_];
 
-               //get delay spread
-               temp.delaySpread.push_back(exponential(delayRMS_));
-           }
-           //store the jakes fadint for this user
-           (*actualJakesMap)[nodeId].push_back(temp);
-       }
-   }
    // convert carrier frequency from GHz to Hz
    double f = carrierFrequency_ * 1000000000;
 
@@ -1244,10 +1502,10 @@ double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
    for (int i = 0; i < fadingPaths_; i++)
    {
        // Phase shift due to Doppler => t-selectivity.
-       double phi_d = actualJakesMap->at(nodeId).at(band).angleOfArrival[i] * doppler_shift;
+       double phi_d = angleOfArrival[i] * doppler_shift;
 
        // Phase shift due to delay spread => f-selectivity.
-       double phi_i = actualJakesMap->at(nodeId).at(band).delaySpread[i].dbl() * f;
+       double phi_i = delaySpread[i] * f;
 
        // Calculate resulting phase due to t-selective and f-selective fading.
        double phi = 2.00 * M_PI * (phi_d * t.dbl() - phi_i);
@@ -1272,6 +1530,81 @@ double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
    return linearToDb(re_h * re_h + im_h * im_h);
 }
 
+void LteRealisticChannelModel::jakesFadingVector(MacNodeId nodeId, double speed, bool cqiDl, std::vector<double>& fading)
+{
+   // see jakesFading() for the choice of the map
+   JakesFadingMap * actualJakesMap;
+   if (cqiDl)
+       actualJakesMap = obtainUeJakesMap(nodeId);
+   else
+       actualJakesMap = &jakesFadingMap_;
+
+   const JakesFadingData& data = getJakesFadingData(actualJakesMap, nodeId);
+   const unsigned int numEntries = band_ * fadingPaths_;
+   const double* angleOfArrival = data.angleOfArrival.data();
+   const double* delaySpread = data.delaySpread.data();
+
+   // convert carrier frequency from GHz to Hz
+   const double f = carrierFrequency_ * 1000000000;
+
+   //get transmission time start (TTI =1ms)
+   const double t = simtime_t(simTime().dbl() - 0.001).dbl();
+
+   // Compute Doppler shift.
+   const double doppler_shift = (speed * f) / SPEED_OF_LIGHT;
+
+   // attenuation per path, see jakesFading()
+   const double attenuation = (1.00 / sqrt(static_cast<double>(fadingPaths_)));
+
+   // phase of all the paths on all the bands. The operations are the same
+   // as in jakesFading(), in the same order, so that results are identical
+   jakesPhase_.resize(numEntries);
+   double* phi = jakesPhase_.data();
+   for (unsigned int k = 0; k < numEntries; k++)
+       phi[k] = 2.00 * M_PI * ((angleOfArrival[k] * doppler_shift) * t - delaySpread[k] * f);
+
+   // aggregate {Re, Im} over the fading paths of each band
+   fading.resize(band_);
+   for (unsigned int b = 0; b < band_; b++)
+   {
+       const double* bandPhi = phi + b * fadingPaths_;
+       double re_h = 0;
+       double im_h = 0;
+       for (int i = 0; i < fadingPaths_; i++)
+       {
+           re_h = re_h + attenuation * cos(bandPhi[i]);
+           im_h = im_h - attenuation * sin(bandPhi[i]);
+       }
+       fading[b] = linearToDb(re_h * re_h + im_h * im_h);
+   }
+}
+
+const std::vector<double>& LteRealisticChannelModel::computeFadingVector(MacNodeId nodeId, double speed, bool cqiDl)
+{
+   fadingVector_.assign(band_, 0.0);
+   if (!fading_)
+       return fadingVector_;
+
+   if (fadingType_ == RAYLEIGH)
+   {
+       for (unsigned int i = 0; i < band_; i++)
+           fadingVector_[i] = rayleighFading(nodeId, i);
+   }
+   else if (fadingType_ == JAKES)
+   {
+       jakesFadingVector(nodeId, speed, cqiDl, fadingVector_);
+   }
+   return fadingVector_;
+}
+
+double LteRealisticChannelModel::getHarqReduction(unsigned char nTx)
+{
+   // harqReduction_^(nTx-1) is computed once for each number of transmissions
+   while (harqReductionFactor_.size() < nTx)
+       harqReductionFactor_.push_back(pow(harqReduction_, (int)harqReductionFactor_.size()));
+   return harqReductionFactor_[nTx - 1];
+}
+
 bool LteRealisticChannelModel::isCorrupted(LteAirFrame *frame,
        UserControlInfo* lteInfo)
 {
@@ -1321,89 +1654,89 @@ bool LteRealisticChannelModel::isCorrupted(LteAirFrame *frame,
    }
 
    // Take sinr
-   std::vector<double> snrV;
+   std::vector<double>& snrV = sinrBuffer_;
    if (lteInfo->getDirection() == D2D || lteInfo->getDirection() == D2D_MULTI)
    {
        MacNodeId destId = lteInfo->getDestId();
        Coord destCoord = phy_->getCoord();
        MacNodeId enbId = binder_->getNextHop(lteInfo->getSourceId());
-       snrV = getSINR_D2D(frame,lteInfo,destId,destCoord,enbId);
+       computeSINR_D2D(frame,lteInfo,destId,destCoord,enbId,snrV);
    }
    else
    {
-       snrV = getSINR(frame, lteInfo);
+       computeSINR(frame, lteInfo, snrV);
    }
 
    //Get the resource Block id used to transmist this packet
-   RbMap rbmap = lteInfo->getGrantedBlocks();
+   const RbMap& rbmap = lteInfo->getGrantedBlocks();
 
    //Get txmode
    unsigned int itxmode = txModeToIndex[txmode];
 
-   double bler = 0;
-   std::vector<double> totalbler;
+   double success = 1;
    double finalSuccess = 1;
-   RbMap::iterator it;
-   std::map<Band, unsigned int>::iterator jt;
+   const int maxSnr = binder_->phyPisaData.maxSnr();
 
    // for statistic purposes
    double sumSnr = 0.0;
    int usedRBs = 0;
 
    //for each Remote unit used to transmit the packet
-   for (it = rbmap.begin(); it != rbmap.end(); ++it)
+   for (unsigned int r = 0; r < NUM_ANTENNAS; ++r)
    {
+       if (!rbmap.hasRemote((Remote)r))
+           continue;
        //for each logical band used to transmit the packet
-       for (jt = it->second.begin(); jt != it->second.end(); ++jt)
+       for (Band band = 0; band < rbmap.getNumBands(); ++band)
        {
+           unsigned int blocks = rbmap.get((Remote)r, band);
            //this Rb is not allocated
-           if (jt->second == 0)
+           if (blocks == 0)
                continue;
 
            //check the antenna used in Das
            if ((lteInfo->getTxMode() == CL_SPATIAL_MULTIPLEXING
                    || lteInfo->getTxMode() == OL_SPATIAL_MULTIPLEXING)
-                   && rbmap.size() > 1)
+                   && rbmap.getNumRemotes() > 1)
                //we consider only the snr associated to the LB used
-               if (it->first != lteInfo->getCw())
+               if (r != lteInfo->getCw())
                    continue;
 
            //Get the Bler
            if (cqi == 0 || cqi > 15)
-               throw cRuntimeError("A packet has been transmitted with a cqi equal to 0 or greater than 15 cqi:%d txmode:%d dir:%d rb:%d cw:%d rtx:%d", cqi,lteInfo->getTxMode(),dir,jt->second,cw,nTx);
+               throw cRuntimeError("A packet has been transmitted with a cqi equal to 0 or greater than 15 cqi:%d txmode:%d dir:%d rb:%d cw:%d rtx:%d", cqi,lteInfo->getTxMode(),dir,blocks,cw,nTx);
 
            // for statistic purposes
-           sumSnr += snrV[jt->first];
+           sumSnr += snrV[band];
            usedRBs++;
 
-           int snr = snrV[jt->first];//XXX because jt->first is a Band (=unsigned short)
+           int snr = snrV[band];
            if (snr < 0)
                return false;
-           else if (snr > binder_->phyPisaData.maxSnr())
-               bler = 0;
+           else if (snr > maxSnr)
+               success = 1;
            else
-               bler = binder_->phyPisaData.getBler(itxmode, cqi - 1, snr);
+               success = binder_->phyPisaData.getSuccessProbability(itxmode, cqi - 1, snr);
 
            EV << "\t bler computation: [itxMode=" << itxmode << "] - [cqi-1=" << cqi-1
                    << "] - [snr=" << snr << "]" << endl;
 
-           double success = 1 - bler;
            //compute the success probability according to the number of RB used
-           double successPacket = pow(success, (double)jt->second);
+           double successPacket = (blocks == 1) ? success : pow(success, (double)blocks);
            // compute the success probability according to the number of LB used
            finalSuccess *= successPacket;
 
            EV << " LteRealisticChannelModel::error direction " << dirToA(dir)
-                              << " node " << id << " remote unit " << dasToA((*it).first)
-                              << " Band " << (*jt).first << " SNR " << snr << " CQI " << cqi
-                              << " BLER " << bler << " success probability " << successPacket
+                              << " node " << id << " remote unit " << dasToA((Remote)r)
+                              << " Band " << band << " SNR " << snr << " CQI " << cqi
+                              << " BLER " << 1 - success << " success probability " << successPacket
                               << " total success probability " << finalSuccess << endl;
        }
    }
    //Compute total error probability
    double per = 1 - finalSuccess;
    //Harq Reduction
-   double totalPer = per * pow(harqReduction_, nTx - 1);
+   double totalPer = per * getHarqReduction(nTx);
 
    double er = uniform(0.0, 1.0);
 
@@ -1477,7 +1810,7 @@ bool LteRealisticChannelModel::isCorrupted_D2D(LteAirFrame *frame, UserControlIn
            return false;
    }
    // SINR vector(one SINR value for each band)
-   std::vector<double> snrV;
+   std::vector<double>& snrV = sinrBuffer_;
    if (lteInfo->getDirection() == D2D || lteInfo->getDirection() == D2D_MULTI)
    {
        MacNodeId peerUeMacNodeId = lteInfo->getDestId();
@@ -1487,27 +1820,25 @@ bool LteRealisticChannelModel::isCorrupted_D2D(LteAirFrame *frame, UserControlIn
 
        if (lteInfo->getDirection() == D2D)
        {
-           snrV = getSINR_D2D(frame,lteInfo,peerUeMacNodeId,peerCoord,enbId);
+           computeSINR_D2D(frame,lteInfo,peerUeMacNodeId,peerCoord,enbId,snrV);
        }
        else  // D2D_MULTI
        {
-           snrV = getSINR_D2D(frame,lteInfo,peerUeMacNodeId,peerCoord,enbId,rsrpVector);
+           computeSINR_D2D(frame,lteInfo,peerUeMacNodeId,peerCoord,enbId,rsrpVector,snrV);
        }
    }
    //ROSSALI-------END------------------------------------------------
-   else  snrV = getSINR(frame, lteInfo); // Take SINR
+   else  computeSINR(frame, lteInfo, snrV); // Take SINR
 
    //Get the resource Block id used to transmit this packet
-   RbMap rbmap = lteInfo->getGrantedBlocks();
+   const RbMap& rbmap = lteInfo->getGrantedBlocks();
 
    //Get txmode
    unsigned int itxmode = txModeToIndex[txmode];
 
-   double bler = 0;
-   std::vector<double> totalbler;
+   double success = 1;
    double finalSuccess = 1;
-   RbMap::iterator it;
-   std::map<Band, unsigned int>::iterator jt;
+   const int maxSnr = binder_->phyPisaData.maxSnr();
 
 
    // for statistic purposes
@@ -1515,58 +1846,60 @@ bool LteRealisticChannelModel::isCorrupted_D2D(LteAirFrame *frame, UserControlIn
    int usedRBs = 0;
 
    //for each Remote unit used to transmit the packet
-   for (it = rbmap.begin(); it != rbmap.end(); ++it)
+   for (unsigned int r = 0; r < NUM_ANTENNAS; ++r)
    {
+       if (!rbmap.hasRemote((Remote)r))
+           continue;
        //for each logical band used to transmit the packet
-       for (jt = it->second.begin(); jt != it->second.end(); ++jt)
+       for (Band band = 0; band < rbmap.getNumBands(); ++band)
        {
+           unsigned int blocks = rbmap.get((Remote)r, band);
            //this Rb is not allocated
-           if (jt->second == 0) continue;
+           if (blocks == 0) continue;
 
            //check the antenna used in Das
            if ((lteInfo->getTxMode() == CL_SPATIAL_MULTIPLEXING
                    || lteInfo->getTxMode() == OL_SPATIAL_MULTIPLEXING)
-               && rbmap.size() > 1)
+               && rbmap.getNumRemotes() > 1)
            //we consider only the snr associated to the LB used
-           if (it->first != lteInfo->getCw()) continue;
+           if (r != lteInfo->getCw()) continue;
 
            //Get the Bler
            if (cqi == 0 || cqi > 15)
-               throw cRuntimeError("A packet has been transmitted with a cqi equal to 0 or greater than 15 cqi:%d txmode:%d dir:%d rb:%d cw:%d rtx:%d", cqi,lteInfo->getTxMode(),dir,jt->second,cw,nTx);
+               throw cRuntimeError("A packet has been transmitted with a cqi equal to 0 or greater than 15 cqi:%d txmode:%d dir:%d rb:%d cw:%d rtx:%d", cqi,lteInfo->getTxMode(),dir,blocks,cw,nTx);
 
            // for statistic purposes
-           sumSnr += snrV[jt->first];
+           sumSnr += snrV[band];
            usedRBs++;
 
-           int snr = snrV[jt->first];//XXX because jt->first is a Band (=unsigned short)
+           int snr = snrV[band];
            if (snr < 1)   // XXX it was < 0
                return false;
-           else if (snr > binder_->phyPisaData.maxSnr())
-                   bler = 0;
-               else
-                   bler = binder_->phyPisaData.getBler(itxmode, cqi - 1, snr);
+           else if (snr > maxSnr)
+               success = 1;
+           else
+               success = binder_->phyPisaData.getSuccessProbability(itxmode, cqi - 1, snr);
 
            EV << "\t bler computation: [itxMode=" << itxmode << "] - [cqi-1=" << cqi-1
               << "] - [snr=" << snr << "]" << endl;
 
-           double success = 1 - bler;
            //compute the success probability according to the number of RB used
-           double successPacket = pow(success, (double)jt->second);
+           double successPacket = (blocks == 1) ? success : pow(success, (double)blocks);
 
            // compute the success probability according to the number of LB used
            finalSuccess *= successPacket;
 
            EV << " LteRealisticChannelModel::error direction " << dirToA(dir)
-              << " node " << id << " remote unit " << dasToA((*it).first)
-              << " Band " << (*jt).first << " SNR " << snr << " CQI " << cqi
-              << " BLER " << bler << " success probability " << successPacket
+              << " node " << id << " remote unit " << dasToA((Remote)r)
+              << " Band " << band << " SNR " << snr << " CQI " << cqi
+              << " BLER " << 1 - success << " success probability " << successPacket
               << " total success probability " << finalSuccess << endl;
        }
    }
    // Compute total error probability
    double per = 1 - finalSuccess;
    // Harq Reduction
-   double totalPer = per * pow(harqReduction_, nTx - 1);
+   double totalPer = per * getHarqReduction(nTx);
 
    double er = uniform(0.0, 1.0);
 
@@ -1886,13 +2219,16 @@ double LteRealisticChannelModel::getStdDev(bool dist, MacNodeId nodeId)
 }
 
 bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNodeId nodeId, Coord coord, bool isCqi,
-       std::vector<double>* interference)
+       std::vector<double>* interference, const RbMap* grantedBlocks)
 {
    EV << "**** Ext Cell Interference **** " << endl;
 
+   if (useExtCellInterferenceMap_)
+       return sampleExtCellInterference(nodeId, coord, interference, grantedBlocks);
+
    // get external cell list
-   ExtCellList list = binder_->getExtCellList();
-   ExtCellList::iterator it = list.begin();
+   const ExtCellList& list = binder_->getExtCellList();
+   ExtCellList::const_iterator it = list.begin();
 
    Coord c;
    double dist, // meters
@@ -1916,26 +2252,7 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
        // compute attenuation according to some path loss model
        att = computeExtCellPathLoss(dist, nodeId);
 
-       //=============== ANGOLAR ATTENUATION =================
-       if ((*it)->getTxDirection() == OMNI)
-       {
-           angolarAtt = 0;
-       }
-       else
-       {
-           // compute the angle between uePosition and reference axis, considering the eNb as center
-           double ueAngle = computeAngle(c, coord);
-
-           // compute the reception angle between ue and eNb
-           double recvAngle = fabs((*it)->getTxAngle() - ueAngle);
-
-           if (recvAngle > 180)
-               recvAngle = 360 - recvAngle;
-
-           // compute attenuation due to sectorial tx
-           angolarAtt = computeAngolarAttenuation(recvAngle);
-       }
-       //=============== END ANGOLAR ATTENUATION =================
+       angolarAtt = computeExtCellAngolarAttenuation(*it, coord);
 
        // TODO do we need to use (- cableLoss_ + antennaGainEnB_) in ext cells too?
        // compute and linearize received power
@@ -1944,6 +2261,10 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
 
        // add interference in those bands where the ext cell is active
        for (unsigned int i = 0; i < band_; i++) {
+           // the SINR is not evaluated on bands out of the grant
+           if (grantedBlocks != NULL && !grantedBlocks->isBandUsed(i))
+               continue;
+
            int occ;
            if (isCqi)  // check slot occupation for this TTI
            {
@@ -1967,6 +2288,76 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
    return true;
 }
 
+bool LteRealisticChannelModel::sampleExtCellInterference(MacNodeId nodeId, Coord coord, std::vector<double>* interference,
+       const RbMap* grantedBlocks)
+{
+   bool los = losMap_[nodeId];
+
+   const std::vector<double>* pixel = extCellInterferenceMap_->sample(coord, los);
+   if (pixel == NULL)
+   {
+       // first receiver within this pixel: compute the interference at its center,
+       // weighting each ext cell by its average band occupation. The pixel does not
+       // depend on the receiver, as its shadowing is applied below
+       Coord center = extCellInterferenceMap_->getPixelCenter(coord);
+       std::vector<double>& field = extCellPixel_;
+       field.assign(band_, 0.0);
+
+       const ExtCellList& list = binder_->getExtCellList();
+       for (ExtCellList::const_iterator it = list.begin(); it != list.end(); ++it)
+       {
+           double dist = center.distance((*it)->getPosition());
+           double dbp = 0;
+           double att = computePathLoss(dist, dbp, los);
+           double angolarAtt = computeExtCellAngolarAttenuation(*it, center);
+
+           double recvPwr = dBmToLinear((*it)->getTxPower() - att - angolarAtt - cableLoss_ + antennaGainEnB_ + antennaGainUe_);
+           for (unsigned int i = 0; i < band_; i++)
+               field[i] += recvPwr * (*it)->getBandLoad(i);
+       }
+       pixel = extCellInterferenceMap_->store(coord, los, field);
+
+       EV << "\t computed interference map pixel centered in [" << center.x << "," << center.y << "]" << endl;
+   }
+   else if (pixel->size() != band_)
+       throw cRuntimeError("LteRealisticChannelModel::sampleExtCellInterference - the shared interference map has %d bands, %d expected",
+           (int)pixel->size(), (int)band_);
+
+   // the shadowing toward the node is the same for all the ext cells (see computeExtCellPathLoss())
+   double shadowing = 1.0;
+   if (shadowing_)
+       shadowing = dBToLinear(-lastComputedSF_.at(nodeId).second);
+
+   for (unsigned int i = 0; i < band_; i++)
+   {
+       // the SINR is not evaluated on bands out of the grant
+       if (grantedBlocks != NULL && !grantedBlocks->isBandUsed(i))
+           continue;
+
+       (*interference)[i] += (*pixel)[i] * shadowing;
+   }
+
+   return true;
+}
+
+double LteRealisticChannelModel::computeExtCellAngolarAttenuation(ExtCell* extCell, Coord coord)
+{
+   if (extCell->getTxDirection() == OMNI)
+       return 0;
+
+   // compute the angle between uePosition and reference axis, considering the eNb as center
+   double ueAngle = computeAngle(extCell->getPosition(), coord);
+
+   // compute the reception angle between ue and eNb
+   double recvAngle = fabs(extCell->getTxAngle() - ueAngle);
+
+   if (recvAngle > 180)
+       recvAngle = 360 - recvAngle;
+
+   // compute attenuation due to sectorial tx
+   return computeAngolarAttenuation(recvAngle);
+}
+
 double LteRealisticChannelModel::computeExtCellPathLoss(double dist, MacNodeId nodeId)
 {
    // double movement = .0;
@@ -2031,8 +2422,9 @@ double LteRealisticChannelModel::computeExtCellPathLoss(double dist, MacNodeId n
 LteRealisticChannelModel::JakesFadingMap * LteRealisticChannelModel::obtainUeJakesMap(MacNodeId id)
 {
    // obtain a reference to UE phy
-   LtePhyBase * ltePhy = check_and_cast<LtePhyBase*>(
-           getSimulation()->getModule(binder_->getOmnetId(id))->getSubmodule("lteNic")->getSubmodule("phy"));
+   LtePhyBase * ltePhy = binder_->getPhyByMacNodeId(id);
+   if (ltePhy == NULL)
+       throw cRuntimeError("LteRealisticChannelModel::obtainUeJakesMap - node %d not found", id);
 
    // get the associated channel and get a reference to its Jakes Map
    LteRealisticChannelModel * re = dynamic_cast<LteRealisticChannelModel *>(ltePhy->getChannelModel());
@@ -2055,6 +2447,23 @@ bool LteRealisticChannelModel::computeDownlinkInterference(MacNodeId eNbId, MacN
    double txPwr;
 
    std::vector<EnbInfo*> * enbList = binder_->getEnbList();
+   if (binder_->hasInterferenceCutoff())
+   {
+       // visit only the eNBs within the cutoff distance from the UE
+       nearbyNodes_.clear();
+       binder_->getEnbsInRange(coord, binder_->getInterferenceCutoffDistance(), nearbyNodes_);
+       std::sort(nearbyNodes_.begin(), nearbyNodes_.end());
+
+       nearbyEnbs_.clear();
+       std::vector<MacNodeId>::iterator nt = nearbyNodes_.begin();
+       for (; nt != nearbyNodes_.end(); ++nt)
+       {
+           EnbInfo* info = binder_->getEnbInfo(*nt);
+           if (info != NULL)
+               nearbyEnbs_.push_back(info);
+       }
+       enbList = &nearbyEnbs_;
+   }
    std::vector<EnbInfo*>::iterator it = enbList->begin(), et = enbList->end();
 
    while(it!=et)
@@ -2071,7 +2480,7 @@ bool LteRealisticChannelModel::computeDownlinkInterference(MacNodeId eNbId, MacN
        if(!(*it)->init)
        {
            // obtain a reference to enb phy and obtain tx power
-           ltePhy = check_and_cast<LtePhyBase*>(getSimulation()->getModule(binder_->getOmnetId(id))->getSubmodule("lteNic")->getSubmodule("phy"));
+           ltePhy = binder_->getPhyByMacNodeId(id);
            (*it)->txPwr = ltePhy->getTxPwr();//dBm
 
            // get tx direction
@@ -2135,7 +2544,7 @@ bool LteRealisticChannelModel::computeDownlinkInterference(MacNodeId eNbId, MacN
            {
                // if we are decoding a data transmission and this RB has not been used, skip it
                // TODO fix for multi-antenna case
-               if (rbmap.at(MACRO).at(i) == 0)
+               if (rbmap.at(MACRO, i) == 0)
                    continue;
 
                // compute the number of occupied slot (unnecessary)
@@ -2152,6 +2561,17 @@ bool LteRealisticChannelModel::computeDownlinkInterference(MacNodeId eNbId, MacN
    return true;
 }
 
+bool LteRealisticChannelModel::collectNearbyUes(const Coord& coord)
+{
+   if (!binder_->hasInterferenceCutoff())
+       return false;
+
+   nearbyNodes_.clear();
+   binder_->getUesInRange(coord, binder_->getInterferenceCutoffDistance(), nearbyNodes_);
+   std::sort(nearbyNodes_.begin(), nearbyNodes_.end());
+   return true;
+}
+
 bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNodeId senderId, bool isCqi, const RbMap& rbmap, std::vector<double> * interference)
 {
    EV << "**** Uplink Interference for cellId[" << eNbId << "] node["<<senderId<<"] ****" << endl;
@@ -2160,6 +2580,9 @@ bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNod
    const std::vector<UeAllocationInfo>* allocatedUes;
    std::vector<UeAllocationInfo>::const_iterator ue_it, ue_et;
 
+   // restrict the computation to the UEs within the cutoff distance from the receiver, if any
+   bool cutoff = collectNearbyUes(phy_->getCoord());
+
    if(isCqi)// check slot occupation for this TTI
    {
        for(unsigned int i=0;i<band_;i++)
@@ -2168,19 +2591,25 @@ bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNod
            allocatedUes = binder_->getUlTransmissionMap(CURR_TTI, i);
            if (allocatedUes->empty()) // no UEs allocated on this band
                continue;
+           if (binder_->getUlTransmissionCell(CURR_TTI, i) == eNbId) // all the UEs belong to the serving cell
+               continue;
 
            ue_it = allocatedUes->begin(), ue_et = allocatedUes->end();
            for (; ue_it != ue_et; ++ue_it)
            {
                MacNodeId ueId = ue_it->nodeId;
                MacCellId cellId = ue_it->cellId;
-               LtePhyUe* uePhy = check_and_cast<LtePhyUe*>(ue_it->phy);
+               LtePhyBase* uePhy = ue_it->phy;
                Direction dir = ue_it->dir;
 
                // no self interference
                if (ueId == senderId)
                    continue;
 
+               // interferer out of range
+               if (cutoff && !isNearbyUe(ueId))
+                   continue;
+
                // no interference from UL/D2D connections of the same cell  (no D2D-UL reuse allowed)
                if (cellId == eNbId)
                    continue;
@@ -2188,7 +2617,7 @@ bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNod
                EV<<NOW<<" LteRealisticChannelModel::computeUplinkInterference - Interference from UE: "<< ueId << "(dir " << dirToA(dir) << ") on band[" << i << "]" << endl;
 
                // get tx power and attenuation from this UE
-               double txPwr = uePhy->getTxPwr(dir) - cableLoss_ + antennaGainUe_ + antennaGainEnB_;
+               double txPwr = ue_it->txPower - cableLoss_ + antennaGainUe_ + antennaGainEnB_;
                double att = getAttenuation(ueId, UL, uePhy->getCoord());
                (*interference)[i] += dBmToLinear(txPwr-att);//(dBm-dB)=dBm
 
@@ -2203,25 +2632,31 @@ bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNod
        {
            // if we are decoding a data transmission and this RB has not been used, skip it
            // TODO fix for multi-antenna case
-           if (rbmap.at(MACRO).at(i) == 0)
+           if (rbmap.at(MACRO, i) == 0)
                continue;
 
            allocatedUes = binder_->getUlTransmissionMap(PREV_TTI, i);
            if (allocatedUes->empty()) // no UEs allocated on this band
                continue;
+           if (binder_->getUlTransmissionCell(PREV_TTI, i) == eNbId) // all the UEs belong to the serving cell
+               continue;
 
            ue_it = allocatedUes->begin(), ue_et = allocatedUes->end();
            for (; ue_it != ue_et; ++ue_it)
            {
                MacNodeId ueId = ue_it->nodeId;
                MacCellId cellId = ue_it->cellId;
-               LtePhyUe* uePhy = check_and_cast<LtePhyUe*>(ue_it->phy);
+               LtePhyBase* uePhy = ue_it->phy;
                Direction dir = ue_it->dir;
 
                // no self interference
                if (ueId == senderId)
                    continue;
 
+               // interferer out of range
+               if (cutoff && !isNearbyUe(ueId))
+                   continue;
+
                // no interference from UL connections of the same cell (no D2D-UL reuse allowed)
                if (cellId == eNbId)
                    continue;
@@ -2229,7 +2664,7 @@ bool LteRealisticChannelModel::computeUplinkInterference(MacNodeId eNbId, MacNod
                EV<<NOW<<" LteRealisticChannelModel::computeUplinkInterference - Interference from UE: "<< ueId << "(dir " << dirToA(dir) << ") on band[" << i << "]" << endl;
 
                // get tx power and attenuation from this UE
-               double txPwr = uePhy->getTxPwr(dir) - cableLoss_ + antennaGainUe_ + antennaGainEnB_;
+               double txPwr = ue_it->txPower - cableLoss_ + antennaGainUe_ + antennaGainEnB_;
                double att = getAttenuation(ueId, UL, uePhy->getCoord());
                (*interference)[i] += dBmToLinear(txPwr-att);//(dBm-dB)=dBm
 
@@ -2257,6 +2692,12 @@ bool LteRealisticChannelModel::computeD2DInterference(MacNodeId eNbId, MacNodeId
    const std::vector<UeAllocationInfo>* allocatedUes;
    std::vector<UeAllocationInfo>::const_iterator ue_it, ue_et;
 
+   // restrict the computation to the UEs within the cutoff distance from the receiver, if any
+   bool cutoff = collectNearbyUes(destCoord);
+
+   // when reuse is disabled, no UE of the same cell interferes, hence bands used only by the latter can be skipped
+   MacCellId sameCellSkip = (!macEnb->isReuseD2DEnabled() && !macEnb->isReuseD2DMultiEnabled()) ? eNbId : 0;
+
    if(isCqi)// check slot occupation for this TTI
    {
        for(unsigned int i=0;i<band_;i++)
@@ -2265,19 +2706,25 @@ bool LteRealisticChannelModel::computeD2DInterference(MacNodeId eNbId, MacNodeId
            allocatedUes = binder_->getUlTransmissionMap(CURR_TTI, i);
            if (allocatedUes->empty()) // no UEs allocated on this band
                continue;
+           if (sameCellSkip != 0 && binder_->getUlTransmissionCell(CURR_TTI, i) == sameCellSkip) // all the UEs belong to the serving cell
+               continue;
 
            ue_it = allocatedUes->begin(), ue_et = allocatedUes->end();
            for (; ue_it != ue_et; ++ue_it)
            {
                MacNodeId ueId = ue_it->nodeId;
                MacCellId cellId = ue_it->cellId;
-               LtePhyUe* uePhy = check_and_cast<LtePhyUe*>(ue_it->phy);
+               LtePhyBase* uePhy = ue_it->phy;
                Direction dir = ue_it->dir;
 
                // no self interference
                if (ueId == senderId || ueId == destId)
                    continue;
 
+               // interferer out of range
+               if (cutoff && !isNearbyUe(ueId))
+                   continue;
+
                // no interference from UL connections of the same cell (no D2D-UL reuse allowed)
                if (dir == UL && cellId == eNbId)
                    continue;
@@ -2289,7 +2736,7 @@ bool LteRealisticChannelModel::computeD2DInterference(MacNodeId eNbId, MacNodeId
                EV<<NOW<<" LteRealisticChannelModel::computeD2DInterference - Interference from UE: "<< ueId << "(dir " << dirToA(dir) << ") on band[" << i << "]" << endl;
 
                // get tx power and attenuation from this UE
-               double txPwr = uePhy->getTxPwr(dir) - cableLoss_ + 2 * antennaGainUe_;
+               double txPwr = ue_it->txPower - cableLoss_ + 2 * antennaGainUe_;
                double att = getAttenuation_D2D(ueId, D2D, uePhy->getCoord(), destId, destCoord);
                (*interference)[i] += dBmToLinear(txPwr-att);//(dBm-dB)=dBm
 
@@ -2304,25 +2751,31 @@ bool LteRealisticChannelModel::computeD2DInterference(MacNodeId eNbId, MacNodeId
        {
 //           // if we are decoding a data transmission and this RB has not been used, skip it
 //           // TODO fix for multi-antenna case
-//           if (rbmap.at(MACRO).at(i) == 0)
+//           if (rbmap.at(MACRO, i) == 0)
 //               continue;
 
            allocatedUes = binder_->getUlTransmissionMap(PREV_TTI, i);
            if (allocatedUes->empty()) // no UEs allocated on this band
                continue;
+           if (sameCellSkip != 0 && binder_->getUlTransmissionCell(PREV_TTI, i) == sameCellSkip) // all the UEs belong to the serving cell
+               continue;
 
            ue_it = allocatedUes->begin(), ue_et = allocatedUes->end();
            for (; ue_it != ue_et; ++ue_it)
            {
                MacNodeId ueId = ue_it->nodeId;
                MacCellId cellId = ue_it->cellId;
-               LtePhyUe* uePhy = check_and_cast<LtePhyUe*>(ue_it->phy);
+               LtePhyBase* uePhy = ue_it->phy;
                Direction dir = ue_it->dir;
 
                // no self interference
                if (ueId == senderId || ueId == destId)
                    continue;
 
+               // interferer out of range
+               if (cutoff && !isNearbyUe(ueId))
+                   continue;
+
                // no interference from UL connections of the same cell (no D2D-UL reuse allowed)
                if (dir == UL && cellId == eNbId)
                    continue;
@@ -2334,7 +2787,7 @@ bool LteRealisticChannelModel::computeD2DInterference(MacNodeId eNbId, MacNodeId
                EV<<NOW<<" LteRealisticChannelModel::computeD2DInterference - Interference from UE: "<< ueId << "(dir " << dirToA(dir) << ") on band[" << i << "]" << endl;
 
                // get tx power and attenuation from this UE
-               double txPwr = uePhy->getTxPwr(dir) - cableLoss_ + 2 * antennaGainUe_;
+               double txPwr = ue_it->txPower - cableLoss_ + 2 * antennaGainUe_;
                double att = getAttenuation_D2D(ueId, D2D, uePhy->getCoord(), destId, destCoord);
                (*interference)[i] += dBmToLinear(txPwr-att);//(dBm-dB)=dBm
 
@@ -18,6 +18,7 @@
 
 #include <omnetpp.h>
 #include "stack/phy/ChannelModel/LteChannelModel.h"
+#include "stack/phy/ChannelModel/ExtCellInterferenceMap.h"
 
 class LteBinder;
 
@@ -72,6 +73,8 @@ private:
 
   //percentage of error probability reduction for each h-arq retransmission
   double harqReduction_;
+  // harqReduction_^(n) for n = 0, 1, ..., indexed by the number of retransmissions
+  std::vector<double> harqReductionFactor_;
 
   // eigen values of channel matrix
   //used to compute the rank
@@ -114,18 +117,40 @@ private:
 
   bool tolerateMaxDistViolation_;
 
-  //Struct used to store information about jakes fading
+  /*
+   * Struct used to store information about jakes fading of a node.
+   * Data of all bands are stored in contiguous arrays (structure-of-arrays),
+   * where the entry of path i on band b is at index (b * fadingPaths_ + i)
+   */
   struct JakesFadingData
   {
       std::vector<double> angleOfArrival;
-      std::vector<omnetpp::simtime_t> delaySpread;
+      // delay spread in seconds, already rounded to the simtime resolution
+      std::vector<double> delaySpread;
   };
 
-  // for each node and for each band we store information about jakes fading
-  std::map<MacNodeId, std::vector<JakesFadingData> > jakesFadingMap_;
+  typedef std::map<MacNodeId, JakesFadingData> JakesFadingMap;
+
+  // for each node we store information about jakes fading on all bands
+  JakesFadingMap jakesFadingMap_;
+
+  // if true, fading is computed for all bands at once (see computeFadingVector())
+  bool batchedFading_;
+
+  // if true, the SINR of data frames is evaluated on the granted bands only
+  bool lazySinr_;
+  // number of bands whose SINR evaluation has been skipped in lazy mode
+  unsigned long skippedSinrBands_;
 
-  typedef std::vector<JakesFadingData> JakesFadingVector;
-  typedef std::map<MacNodeId, JakesFadingVector> JakesFadingMap;
+  // if true, the interference of the external cells is sampled from the map shared through the binder
+  bool useExtCellInterferenceMap_;
+  ExtCellInterferenceMap* extCellInterferenceMap_;
+  // scratch buffer used to compute the pixels of the map
+  std::vector<double> extCellPixel_;
+
+  // scratch buffers used by jakesFadingVector()
+  std::vector<double> jakesPhase_;
+  std::vector<double> fadingVector_;
 
   enum FadingType
   {
@@ -144,21 +169,119 @@ private:
   // statistics
   omnetpp::simsignal_t rcvdSinr_;
 
+  /*
+   * Attenuation cache
+   *
+   * Path loss and shadowing toward a given UE do not change within a TTI, as long as the
+   * UE does not move. The entries of a UE are stored in the slot indexed by its id, and
+   * are keyed by (eNB id, direction, position of the far end). A slot is emptied, keeping
+   * its storage, on its first access in a new TTI.
+   */
+  struct AttenuationCacheEntry
+  {
+      MacNodeId enbId;
+      Direction dir;
+      inet::Coord coord;
+      double attenuation;
+  };
+  struct AttenuationCacheSlot
+  {
+      omnetpp::simtime_t epoch;
+      std::vector<AttenuationCacheEntry> entries;
+  };
+  typedef std::vector<AttenuationCacheSlot> AttenuationCache;
+
+  // enable/disable the per-TTI attenuation cache
+  bool enableAttenuationCache_;
+
+  // attenuation values computed within the current TTI, indexed by UE id
+  AttenuationCache attenuationCache_;
+
+  // cache statistics, recorded as scalars at the end of the simulation
+  unsigned long attenuationCacheHits_;
+  unsigned long attenuationCacheMisses_;
+
+  // scratch buffers used to store the interferers within the cutoff distance (see LteBinder)
+  std::vector<MacNodeId> nearbyNodes_;
+  std::vector<EnbInfo*> nearbyEnbs_;
+
+  /*
+   * Collect the UEs within the interference cutoff distance from the given point
+   * into nearbyNodes_. Returns false if no cutoff is configured
+   */
+  bool collectNearbyUes(const inet::Coord& coord);
+
+  /*
+   * Returns true if the given UE has been collected by collectNearbyUes()
+   */
+  bool isNearbyUe(MacNodeId id) const
+  {
+      return std::binary_search(nearbyNodes_.begin(), nearbyNodes_.end(), id);
+  }
+
+  /*
+   * Compute attenuation (path loss + shadowing), bypassing the cache
+   */
+  double computeAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord);
+
+  /*
+   * Remove the cached entries of the given node. Needed when its LOS or shadowing state
+   * is updated outside getAttenuation() within the same TTI (e.g. by D2D computations)
+   */
+  void invalidateAttenuationCache(MacNodeId nodeId);
+
+  /*
+   * Return the error probability reduction for the given number of transmissions
+   */
+  double getHarqReduction(unsigned char nTx);
+
+  // scratch buffers of the SINR computation (see computeSINR() and computeSINR_D2D())
+  std::vector<double> multiCellInterference_;
+  std::vector<double> extCellInterference_;
+  std::vector<double> d2dInterference_;
+  std::vector<double> sinrBuffer_;
+
+  /*
+   * Heap allocations performed by prepareBuffer(). In steady state the SINR computation
+   * does not allocate, hence the counters stop increasing after the first TTIs
+   */
+  unsigned long sinrAllocations_;
+  // allocations within the current TTI, and maximum over all TTIs
+  unsigned long sinrAllocationsTti_;
+  unsigned long maxSinrAllocationsTti_;
+  // TTI of the last allocation
+  omnetpp::simtime_t lastSinrAllocation_;
+
+  /*
+   * Resize the buffer to the number of bands and set all its entries to the given value,
+   * updating the allocation counters if the buffer needs to grow
+   */
+  void prepareBuffer(std::vector<double>& buffer, double value = 0.0);
+
 
 public:
   virtual void initialize();
+  virtual void finish();
 
   virtual void setBand( unsigned int band );
   virtual void setPhy( LtePhyBase * phy );
 
   /*
    * Compute Attenuation caused by pathloss and shadowing (optional)
+   * Values are cached for the current TTI, see attenuationCache_
    *
    * @param nodeid mac node id of UE
    * @param dir traffic direction
    * @param coord position of end point comunication (if dir==UL is the position of UE else is the position of eNodeB)
    */
   virtual double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord);
+  /*
+   * Same as above, for the link between the given UE and eNodeB.
+   * The eNodeB id is part of the key of the cached values
+   *
+   * @param enbId mac node id of the eNodeB
+   */
+  double getAttenuation(MacNodeId nodeId, Direction dir, inet::Coord coord, MacNodeId enbId);
   /*
    * Compute Attenuation for D2D caused by pathloss and shadowing (optional)
    *
@@ -180,7 +303,15 @@ public:
    * @param frame pointer to the packet
    * @param lteinfo pointer to the user control info
    */
-  virtual std::vector<double> getSINR(LteAirFrame *frame, UserControlInfo* lteInfo);
+  virtual std::vector<double> getSINR(LteAirFrame *frame, const UserControlInfo* lteInfo);
+  /*
+   * Compute snr for each band for user nodeId according to pathloss, shadowing (optional) and multipath fading,
+   * without interference. Only DL frames received by the UE are supported
+   *
+   * @param frame pointer to the packet
+   * @param lteinfo pointer to the user control info
+   */
+  virtual std::vector<double> getSNR(LteAirFrame *frame, const UserControlInfo* lteInfo);
   /*
    * Compute Received useful signal for D2D transmissions
    */
@@ -193,6 +324,16 @@ public:
    */
   virtual std::vector<double> getSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord,MacNodeId enbId);
   virtual std::vector<double> getSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord,MacNodeId enbId,const  std::vector<double>& rsrpVector);
+  /*
+   * Buffer-based variants of the functions above (see LteChannelModel).
+   * Interference is accumulated into scratch buffers owned by this module, hence
+   * no heap allocation occurs once the buffers have reached the number of bands
+   */
+  virtual void computeSIR(LteAirFrame *frame, UserControlInfo* lteInfo, std::vector<double>& sir);
+  virtual void computeSINR(LteAirFrame *frame, const UserControlInfo* lteInfo, std::vector<double>& sinr);
+  virtual void computeRSRP_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord, std::vector<double>& rsrp);
+  virtual void computeSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord, MacNodeId enbId, std::vector<double>& sinr);
+  virtual void computeSINR_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord, MacNodeId enbId, const std::vector<double>& rsrpVector, std::vector<double>& sinr);
   /*
    * Compute the error probability of the transmitted packet according to cqi used, txmode, and the received power
    * after that it throws a random number in order to check if this packet will be corrupted or not
@@ -286,6 +427,22 @@ public:
    * @param cqiDl if true, the jakesMap in the UE side should be used
    */
   double jakesFading(MacNodeId noedId, double speed, unsigned int band, bool cqiDl);
+  /*
+   * Compute Jakes fading for all the bands at once. Equivalent to calling
+   * jakesFading() for each band, but it works on contiguous arrays so that
+   * the inner loops can be vectorized by the compiler
+   *
+   * @param speed speed of UE
+   * @param nodeid mac node id of UE
+   * @param cqiDl if true, the jakesMap in the UE side should be used
+   * @param fading output vector, resized to the number of bands
+   */
+  void jakesFadingVector(MacNodeId nodeId, double speed, bool cqiDl, std::vector<double>& fading);
+  /*
+   * Compute the fading attenuation (dB) on all the bands, according to the configured
+   * fading type. The result is stored in fadingVector_
+   */
+  const std::vector<double>& computeFadingVector(MacNodeId nodeId, double speed, bool cqiDl);
   /*
    * Compute LOS probability
    *
@@ -303,6 +460,11 @@ public:
   virtual bool isD2DInterferenceEnabled() { return enableD2DInterference_; }
 protected:
 
+  /*
+   * Initialize the jakes fading data for the given node, if needed
+   */
+  JakesFadingData& getJakesFadingData(JakesFadingMap* actualJakesMap, MacNodeId nodeId);
+
   /* compute speed (m/s) for a given node
    * @param nodeid mac node id of UE
    * @return the speed in m/s
@@ -336,7 +498,21 @@ protected:
    * evaluates total interference from external cells seen from the spot given by coord
    * @return total interference expressed in dBm
    */
-  bool computeExtCellInterference(MacNodeId eNbId, MacNodeId nodeId, inet::Coord coord, bool isCqi, std::vector<double>* interference);
+  bool computeExtCellInterference(MacNodeId eNbId, MacNodeId nodeId, inet::Coord coord, bool isCqi, std::vector<double>* interference,
+          const RbMap* grantedBlocks = NULL);
+
+  /*
+   * adds the interference of the external cells sampled from the interference map,
+   * computing the pixel containing coord if needed
+   */
+  bool sampleExtCellInterference(MacNodeId nodeId, inet::Coord coord, std::vector<double>* interference,
+          const RbMap* grantedBlocks);
+
+  /*
+   * compute attenuation due to the sectorial transmission of the external cell
+   * @return attenuation expressed in dB
+   */
+  double computeExtCellAngolarAttenuation(ExtCell* extCell, inet::Coord coord);
 
   /*
    * compute attenuation due to path loss and shadowing
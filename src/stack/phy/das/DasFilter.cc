@@ -43,7 +43,7 @@ void DasFilter::setMasterRuSet(MacNodeId masterId)
     reportingSet_.clear();
 }
 
-double DasFilter::receiveBroadcast(LteAirFrame* frame, UserControlInfo* lteInfo)
+double DasFilter::receiveBroadcast(LteAirFrame* frame, const UserControlInfo* lteInfo, bool snrOnly)
 {
     EV << "DAS Filter: Received Broadcast\n";
     EV << "DAS Filter: ReportingSet now contains:\n";
@@ -53,7 +53,9 @@ double DasFilter::receiveBroadcast(LteAirFrame* frame, UserControlInfo* lteInfo)
     for (unsigned int i=0; i<ruSet_->getAntennaSetSize(); i++)
     {
         // equal bitrate mapping
-        std::vector<double> rssiV = ltePhy_->getChannelModel()->getSINR(frame,lteInfo);
+        std::vector<double> rssiV = snrOnly ?
+            ltePhy_->getChannelModel()->getSNR(frame,lteInfo) :
+            ltePhy_->getChannelModel()->getSINR(frame,lteInfo);
         std::vector<double>::iterator it;
         double rssi = 0;
         for (it=rssiV.begin();it!=rssiV.end();++it)
@@ -74,9 +74,10 @@ class DasFilter
      *
      * @param frame feedback packet received
      * @param myPos position of the UE
+     * @param snrOnly if true, the rssi is computed with getSNR(), i.e. without interference
      * @return rssi received from eNB
      */
-    double receiveBroadcast(LteAirFrame* frame, UserControlInfo* lteInfo);
+    double receiveBroadcast(LteAirFrame* frame, const UserControlInfo* lteInfo, bool snrOnly = false);
 
     /**
      * getReportingSet() returns the current reporting set
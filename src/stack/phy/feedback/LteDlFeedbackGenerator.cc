@@ -9,6 +9,7 @@
 
 #include "stack/phy/feedback/LteDlFeedbackGenerator.h"
 #include "stack/phy/layer/LtePhyUe.h"
+#include "corenetwork/binder/LteBinder.h"
 
 Define_Module(LteDlFeedbackGenerator);
 
@@ -37,6 +38,12 @@ void LteDlFeedbackGenerator::initialize(int stage)
         {
             error("Feedback Period MUST be greater than Feedback Delay");
         }
+        int dormantFbPeriod = par("dormantFbPeriod");
+        dormantFbPeriod_ = (dormantFbPeriod > 0) ? (simtime_t)(dormantFbPeriod * TTI) : fbPeriod_;
+        if (dormantFbPeriod_ <= fbDelay_)
+        {
+            error("Dormant Feedback Period MUST be greater than Feedback Delay");
+        }
         fbType_ = getFeedbackType(par("feedbackType").stringValue());
         rbAllocationType_ = getRbAllocationType(
             par("rbAllocationType").stringValue());
@@ -97,11 +104,23 @@ void LteDlFeedbackGenerator::initialize(int stage)
            << " feedback computation initialize" << endl;
         WATCH(numBands_);
         WATCH(numPreferredBands_);
-        if (usePeriodic_)
+        // with the global TTI clock, periodic sensing starts at the first TTI
+        ttiClock_ = getBinder()->isGlobalTtiClock();
+        if (usePeriodic_ && !ttiClock_)
         {
             tPeriodicSensing_->start(0);
         }
     }
+    else if (stage == INITSTAGE_NETWORK_LAYER)
+    {
+        if (usePeriodic_ && ttiClock_)
+        {
+            // the id of the UE is assigned by the binder at link layer stage
+            nodeId_ = getAncestorPar("macNodeId");
+            nextPeriodicSensing_ = NOW;
+            getBinder()->getTtiClock()->registerClient(LteTtiClock::FEEDBACK_PHASE, nodeId_, this);
+        }
+    }
 }
 
 void LteDlFeedbackGenerator::handleMessage(cMessage *msg)
@@ -113,7 +132,7 @@ void LteDlFeedbackGenerator::handleMessage(cMessage *msg)
     {
         EV << NOW << " Periodic Sensing" << endl;
         tPeriodicSensing_->handle();
-        tPeriodicSensing_->start(fbPeriod_);
+        tPeriodicSensing_->start(dormant_ ? dormantFbPeriod_ : fbPeriod_);
         sensing(PERIODIC);
     }
     else if (type == PERIODIC_TX)
@@ -176,6 +195,9 @@ void LteDlFeedbackGenerator::sensing(FbPeriodicity per)
 
 LteDlFeedbackGenerator::LteDlFeedbackGenerator()
 {
+    ttiClock_ = false;
+    nextPeriodicSensing_ = 0;
+    dormant_ = false;
     tPeriodicSensing_ = NULL;
     tPeriodicTx_ = NULL;
     tAperiodicTx_ = NULL;
@@ -188,6 +210,40 @@ LteDlFeedbackGenerator::~LteDlFeedbackGenerator()
     delete tAperiodicTx_;
 }
 
+void LteDlFeedbackGenerator::handleTti()
+{
+    Enter_Method_Silent("handleTti");
+    if (NOW < nextPeriodicSensing_)
+        return;
+
+    EV << NOW << " Periodic Sensing" << endl;
+    nextPeriodicSensing_ = NOW + (dormant_ ? dormantFbPeriod_ : fbPeriod_);
+    sensing(PERIODIC);
+}
+
+void LteDlFeedbackGenerator::setDormant(bool dormant)
+{
+    Enter_Method_Silent("setDormant()");
+    if (dormant_ == dormant)
+        return;
+    dormant_ = dormant;
+
+    if (dormant_ || !usePeriodic_ || dormantFbPeriod_ <= fbPeriod_)
+        return;
+
+    // back to the regular rate: sense now if the next sensing is farther than a regular period
+    if (ttiClock_)
+    {
+        if (nextPeriodicSensing_ > NOW + fbPeriod_)
+            nextPeriodicSensing_ = NOW;
+    }
+    else if (tPeriodicSensing_->busy() && tPeriodicSensing_->remaining() > fbPeriod_)
+    {
+        tPeriodicSensing_->stop();
+        tPeriodicSensing_->start(0);
+    }
+}
+
 void LteDlFeedbackGenerator::aperiodicRequest()
 {
     Enter_Method("aperiodicRequest()");
@@ -19,6 +19,7 @@
 #include "common/timer/TTimer.h"
 #include "common/timer/TTimerMsg_m.h"
 #include "stack/phy/feedback/LteFeedbackComputation.h"
+#include "corenetwork/binder/LteTtiClock.h"
 
 class DasFilter;
 /**
@@ -26,7 +27,7 @@ class DasFilter;
  * @brief Lte Downlink Feedback Generator
  *
  */
-class LteDlFeedbackGenerator : public omnetpp::cSimpleModule
+class LteDlFeedbackGenerator : public omnetpp::cSimpleModule, public LteTtiClient
 {
     enum FbTimerType
     {
@@ -47,6 +48,8 @@ class LteDlFeedbackGenerator : public omnetpp::cSimpleModule
      */
     omnetpp::simtime_t fbPeriod_;    /// period for Periodic feedback in TTI
     omnetpp::simtime_t fbDelay_;     /// time interval between sensing and transmission in TTI
+    omnetpp::simtime_t dormantFbPeriod_; /// period for Periodic feedback while the UE is dormant
+    bool dormant_;                       /// true if the MAC of the UE is dormant
 
     bool usePeriodic_;      /// true if we want to use also periodic feedback
     TxMode currentTxMode_;  /// transmission mode to use in feedback generation
@@ -64,6 +67,10 @@ class LteDlFeedbackGenerator : public omnetpp::cSimpleModule
     TTimer *tPeriodicTx_;
     TTimer *tAperiodicTx_;
 
+    // when driven by the global TTI clock, periodic sensing is not run by a timer
+    bool ttiClock_;
+    omnetpp::simtime_t nextPeriodicSensing_;
+
     // Feedback Maps
     //typedef std::map<Remote,LteFeedback> FeedbackMap_;
     LteFeedbackDoubleVector periodicFeedback;
@@ -102,7 +109,7 @@ class LteDlFeedbackGenerator : public omnetpp::cSimpleModule
      * Channel sensing
      */
     void sensing(FbPeriodicity per);
-    virtual int numInitStages() const override { return inet::INITSTAGE_LINK_LAYER + 1; }
+    virtual int numInitStages() const override { return inet::INITSTAGE_NETWORK_LAYER + 1; }
 
   public:
 
@@ -135,6 +142,19 @@ class LteDlFeedbackGenerator : public omnetpp::cSimpleModule
      * Update cell id and the reference to the cellInfo
      */
     void handleHandover(MacCellId newEnbId);
+
+    /**
+     * Function used to switch the periodic feedback rate
+     * when the MAC enters or leaves the dormant state.
+     * Called by MAC.
+     */
+    void setDormant(bool dormant);
+
+    /**
+     * Called by the global TTI clock, performs periodic sensing
+     * in place of the sensing timer
+     */
+    virtual void handleTti() override;
 };
 
 #endif
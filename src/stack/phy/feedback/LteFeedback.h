@@ -124,7 +124,7 @@ class LteFeedback
         return rank_;
     }
     //! Get the wide-band CQI. Does not check if valid.
-    CqiVector getWbCqi() const
+    const CqiVector& getWbCqi() const
     {
         return wideBandCqi_;
     }
@@ -139,22 +139,22 @@ class LteFeedback
         return wideBandPmi_;
     }
     //! Get the per-band CQI. Does not check if valid.
-    std::vector<CqiVector> getBandCqi() const
+    const std::vector<CqiVector>& getBandCqi() const
     {
         return perBandCqi_;
     }
     //! Get the per-band CQI for one codeword. Does not check if valid.
-    CqiVector getBandCqi(Codeword cw) const
+    const CqiVector& getBandCqi(Codeword cw) const
     {
         return perBandCqi_[cw];
     }
     //! Get the per-band PMI. Does not check if valid.
-    PmiVector getBandPmi() const
+    const PmiVector& getBandPmi() const
     {
         return perBandPmi_;
     }
     //! Get the per preferred band CQI. Does not check if valid.
-    CqiVector getPreferredCqi() const
+    const CqiVector& getPreferredCqi() const
     {
         return preferredCqi_;
     }
@@ -169,7 +169,7 @@ class LteFeedback
         return preferredPmi_;
     }
     //! Get the set of preferred bands. Does not check if valid.
-    BandSet getPreferredBands() const
+    const BandSet& getPreferredBands() const
     {
         return preferredBands_;
     }
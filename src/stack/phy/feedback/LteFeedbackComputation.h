@@ -30,7 +30,7 @@ class LteFeedbackComputation
     virtual LteFeedbackDoubleVector computeFeedback(FeedbackType fbType, RbAllocationType rbAllocationType,
         TxMode currentTxMode,
         std::map<Remote, int> antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype,
-        int numRus, std::vector<double> snr, MacNodeId id = 0)=0;
+        int numRus, const std::vector<double>& snr, MacNodeId id = 0)=0;
     /**
      * Interface for Feedback computation
      *
@@ -45,7 +45,7 @@ class LteFeedbackComputation
     virtual LteFeedbackVector computeFeedback(const Remote remote, FeedbackType fbType,
         RbAllocationType rbAllocationType, TxMode currentTxMode,
         int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-        std::vector<double> snr, MacNodeId id = 0)=0;
+        const std::vector<double>& snr, MacNodeId id = 0)=0;
     /**
      * Interface for Feedback computation
      *
@@ -61,7 +61,7 @@ class LteFeedbackComputation
     virtual LteFeedback computeFeedback(const Remote remote, TxMode txmode, FeedbackType fbType,
         RbAllocationType rbAllocationType,
         int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-        std::vector<double> snr, MacNodeId id = 0)=0;
+        const std::vector<double>& snr, MacNodeId id = 0)=0;
 };
 
 #endif
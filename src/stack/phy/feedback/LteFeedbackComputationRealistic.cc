@@ -35,7 +35,7 @@ LteFeedbackComputationRealistic::~LteFeedbackComputationRealistic()
 }
 
 void LteFeedbackComputationRealistic::generateBaseFeedback(int numBands, int numPreferredBands, LteFeedback& fb,
-    FeedbackType fbType, int cw, RbAllocationType rbAllocationType, TxMode txmode, std::vector<double> snr)
+    FeedbackType fbType, int cw, RbAllocationType rbAllocationType, TxMode txmode, const std::vector<double>& snr)
 {
     int layer = 1;
     std::vector<CqiVector> cqiTmp2;
@@ -136,7 +136,7 @@ Cqi LteFeedbackComputationRealistic::getCqi(TxMode txmode, double snr)
 LteFeedbackDoubleVector LteFeedbackComputationRealistic::computeFeedback(FeedbackType fbType,
     RbAllocationType rbAllocationType, TxMode currentTxMode,
     std::map<Remote, int> antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-    std::vector<double> snr, MacNodeId id)
+    const std::vector<double>& snr, MacNodeId id)
 {
     //add enodeB to the number of antenna
     numRus++;
@@ -187,7 +187,7 @@ LteFeedbackDoubleVector LteFeedbackComputationRealistic::computeFeedback(Feedbac
 LteFeedbackVector LteFeedbackComputationRealistic::computeFeedback(const Remote remote, FeedbackType fbType,
     RbAllocationType rbAllocationType, TxMode currentTxMode,
     int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-    std::vector<double> snr, MacNodeId id)
+    const std::vector<double>& snr, MacNodeId id)
 {
     // New Feedback
     LteFeedbackVector fbv;
@@ -229,7 +229,7 @@ LteFeedbackVector LteFeedbackComputationRealistic::computeFeedback(const Remote
 LteFeedback LteFeedbackComputationRealistic::computeFeedback(const Remote remote, TxMode txmode, FeedbackType fbType,
     RbAllocationType rbAllocationType,
     int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-    std::vector<double> snr, MacNodeId id)
+    const std::vector<double>& snr, MacNodeId id)
 {
     // New Feedback
     LteFeedback fb;
@@ -259,10 +259,10 @@ LteFeedback LteFeedbackComputationRealistic::computeFeedback(const Remote remote
     return fb;
 }
 
-double LteFeedbackComputationRealistic::meanSnr(std::vector<double> snr)
+double LteFeedbackComputationRealistic::meanSnr(const std::vector<double>& snr)
 {
     double mean = 0;
-    std::vector<double>::iterator it;
+    std::vector<double>::const_iterator it;
     for (it = snr.begin(); it != snr.end(); ++it)
         mean += *it;
     mean /= snr.size();
@@ -35,10 +35,10 @@ class LteFeedbackComputationRealistic : public LteFeedbackComputation
     unsigned int computeRank(MacNodeId id);
     // Generate base feedback for all types of feedback(allbands, preferred, wideband)
     void generateBaseFeedback(int numBands, int numPreferredBabds, LteFeedback& fb, FeedbackType fbType, int cw,
-        RbAllocationType rbAllocationType, TxMode txmode, std::vector<double> snr);
+        RbAllocationType rbAllocationType, TxMode txmode, const std::vector<double>& snr);
     // Get cqi from BLer Curves
     Cqi getCqi(TxMode txmode, double snr);
-    double meanSnr(std::vector<double> snr);
+    double meanSnr(const std::vector<double>& snr);
     public:
     LteFeedbackComputationRealistic(double targetBler, std::map<MacNodeId, Lambda>* lambda, double lambdaMinTh,
         double lambdaMaxTh, double lambdaRatioTh, unsigned int numBands);
@@ -47,17 +47,17 @@ class LteFeedbackComputationRealistic : public LteFeedbackComputation
     virtual LteFeedbackDoubleVector computeFeedback(FeedbackType fbType, RbAllocationType rbAllocationType,
         TxMode currentTxMode,
         std::map<Remote, int> antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype,
-        int numRus, std::vector<double> snr, MacNodeId id = 0);
+        int numRus, const std::vector<double>& snr, MacNodeId id = 0);
 
     virtual LteFeedbackVector computeFeedback(const Remote remote, FeedbackType fbType,
         RbAllocationType rbAllocationType, TxMode currentTxMode,
         int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-        std::vector<double> snr, MacNodeId id = 0);
+        const std::vector<double>& snr, MacNodeId id = 0);
 
     virtual LteFeedback computeFeedback(const Remote remote, TxMode txmode, FeedbackType fbType,
         RbAllocationType rbAllocationType,
         int antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
-        std::vector<double> snr, MacNodeId id = 0);
+        const std::vector<double>& snr, MacNodeId id = 0);
 };
 
 #endif
@@ -7,12 +7,13 @@
 
 #include "stack/phy/feedback/LteSummaryBuffer.h"
 
-void LteSummaryBuffer::createSummary(LteFeedback fb) {
+void LteSummaryBuffer::createSummary(const LteFeedback& fb) {
+    LteSummaryFeedback& cumulativeSummary = summary();
     try {
         // RI
         if (fb.hasRankIndicator()) {
             Rank ri(fb.getRankIndicator());
-            cumulativeSummary_.setRi(ri);
+            cumulativeSummary.setRi(ri);
             if (ri > 1)
                 totCodewords_ = 2;
         }
@@ -20,29 +21,29 @@ void LteSummaryBuffer::createSummary(LteFeedback fb) {
         // CQI
         if (fb.hasBandCqi()) // Per-band
         {
-            std::vector<CqiVector> cqi = fb.getBandCqi();
+            const std::vector<CqiVector>& cqi = fb.getBandCqi();
             unsigned int n = cqi.size();
             for (Codeword cw = 0; cw < n; ++cw)
                 for (Band i = 0; i < totBands_; ++i)
-                    cumulativeSummary_.setCqi(cqi.at(cw).at(i), cw, i);
+                    cumulativeSummary.setCqi(cqi.at(cw).at(i), cw, i);
         } else {
             if (fb.hasWbCqi()) // Wide-band
             {
-                CqiVector cqi(fb.getWbCqi());
+                const CqiVector& cqi = fb.getWbCqi();
                 unsigned int n = cqi.size();
                 for (Codeword cw = 0; cw < n; ++cw)
                     for (Band i = 0; i < totBands_; ++i)
-                        cumulativeSummary_.setCqi(cqi.at(cw), cw, i); // ripete lo stesso wb cqi su ogni banda della stessa cw
+                        cumulativeSummary.setCqi(cqi.at(cw), cw, i); // ripete lo stesso wb cqi su ogni banda della stessa cw
             }
             if (fb.hasPreferredCqi()) // Preferred-band
             {
-                CqiVector cqi(fb.getPreferredCqi());
-                BandSet bands(fb.getPreferredBands());
+                const CqiVector& cqi = fb.getPreferredCqi();
+                const BandSet& bands = fb.getPreferredBands();
                 unsigned int n = cqi.size();
-                BandSet::iterator et = bands.end();
+                BandSet::const_iterator et = bands.end();
                 for (Codeword cw = 0; cw < n; ++cw)
-                    for (BandSet::iterator it = bands.begin(); it != et; ++it)
-                        cumulativeSummary_.setCqi(cqi.at(cw), cw, *it); // mette lo stesso cqi solo sulle bande preferite della stessa cw
+                    for (BandSet::const_iterator it = bands.begin(); it != et; ++it)
+                        cumulativeSummary.setCqi(cqi.at(cw), cw, *it); // mette lo stesso cqi solo sulle bande preferite della stessa cw
             }
         }
 
@@ -51,23 +52,23 @@ void LteSummaryBuffer::createSummary(LteFeedback fb) {
         // PMI
         if (fb.hasBandPmi()) // Per-band
         {
-            PmiVector pmi(fb.getBandPmi());
+            const PmiVector& pmi = fb.getBandPmi();
             for (Band i = 0; i < totBands_; ++i)
-                cumulativeSummary_.setPmi(pmi.at(i), i);
+                cumulativeSummary.setPmi(pmi.at(i), i);
         } else {
             if (fb.hasWbPmi()) {
                 // Wide-band
                 Pmi pmi(fb.getWbPmi());
                 for (Band i = 0; i < totBands_; ++i)
-                    cumulativeSummary_.setPmi(pmi, i);
+                    cumulativeSummary.setPmi(pmi, i);
             }
             if (fb.hasPreferredPmi()) {
                 // Preferred-band
                 Pmi pmi(fb.getPreferredPmi());
-                BandSet bands(fb.getPreferredBands());
-                BandSet::iterator et = bands.end();
-                for (BandSet::iterator it = bands.begin(); it != et; ++it)
-                    cumulativeSummary_.setPmi(pmi, *it);
+                const BandSet& bands = fb.getPreferredBands();
+                BandSet::const_iterator et = bands.end();
+                for (BandSet::const_iterator it = bands.begin(); it != et; ++it)
+                    cumulativeSummary.setPmi(pmi, *it);
             }
         }
     } catch (std::exception& e) {
@@ -9,7 +9,8 @@
 #ifndef STACK_PHY_FEEDBACK_LTESUMMARYBUFFER_H_
 #define STACK_PHY_FEEDBACK_LTESUMMARYBUFFER_H_
 
-#include <list>
+#include <memory>
+#include <vector>
 #include "stack/phy/feedback/LteSummaryBuffer.h"
 #include "stack/phy/feedback/LteFeedback.h"
 
@@ -18,40 +19,82 @@ class LteSummaryBuffer
   protected:
     //! Buffer dimension
     unsigned char bufferSize_;
-    //! The buffer
-    std::list<LteFeedback> buffer_;
+    //! The buffer, used as a ring once bufferSize_ feedbacks have been stored
+    std::vector<LteFeedback> buffer_;
+    //! Position of the oldest feedback in the (full) buffer
+    unsigned char head_;
     //! Number of codewords.
     double totCodewords_;
     //! Number of bands.
     double totBands_;
-    //! Cumulative summary feedback.
-    LteSummaryFeedback cumulativeSummary_;
-    void createSummary(LteFeedback fb);
+    //! Parameters of the summary feedback
+    unsigned char summaryCodewords_;
+    omnetpp::simtime_t lb_;
+    omnetpp::simtime_t ub_;
+    //! Cumulative summary feedback. It is created on first use, so that
+    //! no memory is spent for transmission modes that are never reported
+    mutable std::unique_ptr<LteSummaryFeedback> cumulativeSummary_;
+    void createSummary(const LteFeedback& fb);
+
+    LteSummaryFeedback& summary() const
+    {
+        if (!cumulativeSummary_)
+            cumulativeSummary_.reset(new LteSummaryFeedback(summaryCodewords_, totBands_, lb_, ub_));
+        return *cumulativeSummary_;
+    }
 
   public:
 
     LteSummaryBuffer(unsigned char dim, unsigned char cw, unsigned int b, omnetpp::simtime_t lb, omnetpp::simtime_t ub) :
-        bufferSize_(dim), totCodewords_(cw), totBands_(b), cumulativeSummary_(cw, b, lb, ub)
+        bufferSize_(dim), head_(0), totCodewords_(cw), totBands_(b), summaryCodewords_(cw), lb_(lb), ub_(ub)
     { }
 
+    LteSummaryBuffer(const LteSummaryBuffer& other)
+    {
+        operator=(other);
+    }
+
+    LteSummaryBuffer& operator=(const LteSummaryBuffer& other)
+    {
+        if (this == &other)
+            return *this;
+        bufferSize_ = other.bufferSize_;
+        buffer_ = other.buffer_;
+        head_ = other.head_;
+        totCodewords_ = other.totCodewords_;
+        totBands_ = other.totBands_;
+        summaryCodewords_ = other.summaryCodewords_;
+        lb_ = other.lb_;
+        ub_ = other.ub_;
+        cumulativeSummary_.reset(other.cumulativeSummary_ ? new LteSummaryFeedback(*other.cumulativeSummary_) : NULL);
+        return *this;
+    }
+
     //! Put a feedback into the buffer and update current summary feedback
-    void put(LteFeedback fb)
+    void put(const LteFeedback& fb)
     {
         if (bufferSize_ > 0)
         {
-            buffer_.push_back(fb);
-        }
-        if (buffer_.size() > bufferSize_)
-        {
-            buffer_.pop_front();
+            if (buffer_.size() < bufferSize_)
+            {
+                if (buffer_.empty())
+                    buffer_.reserve(bufferSize_);
+                buffer_.push_back(fb);
+            }
+            else
+            {
+                // overwrite the oldest feedback
+                buffer_[head_] = fb;
+                head_ = (head_ + 1) % bufferSize_;
+            }
         }
         createSummary(fb);
     }
 
     //! Get the current summary feedback
-    LteSummaryFeedback get() const
+    const LteSummaryFeedback& get() const
     {
-        return cumulativeSummary_;
+        return summary();
     }
 };
 
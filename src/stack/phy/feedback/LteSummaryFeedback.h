@@ -154,7 +154,7 @@ class LteSummaryFeedback
         return confidence(tPmi_.at(band));
     }
 
-    bool isValid()
+    bool isValid() const
     {
         return valid_;
     }
@@ -9,6 +9,8 @@
 
 #include "stack/phy/layer/LtePhyBase.h"
 #include "common/LteCommon.h"
+#include <inet/mobility/contract/IMobility.h>
+#include <algorithm>
 
 using namespace omnetpp;
 
@@ -17,6 +19,7 @@ short LtePhyBase::airFramePriority_ = 10;
 LtePhyBase::LtePhyBase()
 {
     channelModel_ = NULL;
+    nodeId_ = 0;
 }
 
 LtePhyBase::~LtePhyBase()
@@ -49,11 +52,31 @@ void LtePhyBase::initialize(int stage)
 
         multicastD2DRange_ = par("multicastD2DRange");
         enableMulticastD2DRangeCheck_ = par("enableMulticastD2DRangeCheck");
+
+        recordControlInfoCopies_ = par("recordControlInfoCopies");
+        controlInfoCopies_ = controlInfoCopiesAvoided_ = 0;
+        WATCH(controlInfoCopies_);
+        WATCH(controlInfoCopiesAvoided_);
     }
     else if (stage == inet::INITSTAGE_PHYSICAL_ENVIRONMENT)
     {
         initializeChannelModel();
     }
+    else if (stage == inet::INITSTAGE_LAST)
+    {
+        // the local id is known at this stage, store the initial position
+        if (nodeId_ != 0)
+            binder_->updateNodePosition(nodeId_, getRadioPosition());
+    }
+}
+
+void LtePhyBase::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details)
+{
+    ChannelAccess::receiveSignal(source, signalID, obj, details);
+
+    // before the local id is known the position will be stored at initialization
+    if (signalID == inet::IMobility::mobilityStateChangedSignal && nodeId_ != 0)
+        binder_->updateNodePosition(nodeId_, getRadioPosition());
 }
 
 void LtePhyBase::handleMessage(cMessage* msg)
@@ -67,6 +90,22 @@ void LtePhyBase::handleMessage(cMessage* msg)
     // AirFrame
     else if (msg->getArrivalGate()->getId() == radioInGate_)
     {
+        LteAirFrame* frame = dynamic_cast<LteAirFrame*>(msg);
+        const UserControlInfo* sharedInfo = (frame != NULL) ? frame->getSharedControlInfo() : NULL;
+        if (sharedInfo != NULL && sharedInfo->getFrameType() == HANDOVERPKT)
+        {
+            // handover broadcasts are only read: use the control info shared among the copies
+            if (!frame->isLastSharedCopy())
+                controlInfoCopiesAvoided_++;
+            handleHandoverBroadcast(frame, sharedInfo);
+            return;
+        }
+
+        // the other frames (e.g. multicast data) need their own control info, which is
+        // passed up the stack: attach a copy of the shared one
+        if (frame != NULL && frame->restoreControlInfo())
+            controlInfoCopies_++;
+
         handleAirFrame(msg);
     }
 
@@ -93,6 +132,21 @@ void LtePhyBase::handleControlMsg(LteAirFrame *frame,
     return;
 }
 
+void LtePhyBase::finish()
+{
+    if (recordControlInfoCopies_)
+    {
+        recordScalar("controlInfoCopies", controlInfoCopies_);
+        recordScalar("controlInfoCopiesAvoided", controlInfoCopiesAvoided_);
+    }
+}
+
+void LtePhyBase::handleHandoverBroadcast(LteAirFrame* frame, const UserControlInfo* lteInfo)
+{
+    EV << "LtePhyBase::handleHandoverBroadcast - handover broadcast from " << lteInfo->getSourceId() << " ignored" << endl;
+    delete frame;
+}
+
 LteAirFrame *LtePhyBase::createHandoverMessage()
 {
     // broadcast airframe
@@ -218,15 +272,10 @@ void LtePhyBase::sendBroadcast(LteAirFrame *airFrame)
 
 LteAmc *LtePhyBase::getAmcModule(MacNodeId id)
 {
-    LteAmc *amc = NULL;
-    OmnetId omid = binder_->getOmnetId(id);
-    if (omid == 0)
+    if (binder_->getOmnetId(id) == 0)
         return NULL;
 
-    amc = check_and_cast<LteMacEnb *>(
-        getSimulation()->getModule(omid)->getSubmodule("lteNic")->getSubmodule(
-            "mac"))->getAmc();
-    return amc;
+    return check_and_cast<LteMacEnb *>(binder_->getMacFromMacNodeId(id))->getAmc();
 }
 
 void LtePhyBase::sendMulticast(LteAirFrame *frame)
@@ -238,6 +287,9 @@ void LtePhyBase::sendMulticast(LteAirFrame *frame)
     if (groupId < 0)
         throw cRuntimeError("LtePhyBase::sendMulticast - Error. Group ID %d is not valid.", groupId);
 
+    // the copies sent to the group members share the control info and the encapsulated packet
+    frame->shareControlInfo();
+
     // send the frame to nodes belonging to the multicast group only
     std::map<int, OmnetId>::const_iterator nodeIt = binder_->getNodeIdListBegin();
     for (; nodeIt != binder_->getNodeIdListEnd(); ++nodeIt)
@@ -253,7 +305,7 @@ void LtePhyBase::sendMulticast(LteAirFrame *frame)
 
             if( enableMulticastD2DRangeCheck_ )
             {
-                recvPhy =  check_and_cast<LtePhyBase *>(receiver->getSubmodule("lteNic")->getSubmodule("phy"));
+                recvPhy = binder_->getPhyByMacNodeId(nodeIt->first);
                 dist = recvPhy->getRadioPosition().distance(getRadioPosition());
 
                 if( dist > multicastD2DRange_ )
@@ -273,6 +325,35 @@ void LtePhyBase::sendMulticast(LteAirFrame *frame)
     delete frame;
 }
 
+unsigned int LtePhyBase::sendBroadcastInRange(LteAirFrame *frame, double range)
+{
+    std::vector<MacNodeId> receivers;
+    binder_->getUesInRange(getRadioPosition(), range, receivers);
+
+    // deliver in node id order, regardless of the layout of the index
+    std::sort(receivers.begin(), receivers.end());
+
+    // the copies share the control info and the encapsulated packet
+    frame->shareControlInfo();
+
+    unsigned int sent = 0;
+    std::vector<MacNodeId>::const_iterator it = receivers.begin();
+    for (; it != receivers.end(); ++it)
+    {
+        OmnetId omnetId = binder_->getOmnetId(*it);
+        if (omnetId == 0)
+            continue;   // node has left the simulation
+
+        cModule *receiver = getSimulation()->getModule(omnetId);
+        sendDirect(frame->dup(), 0, frame->getDuration(), receiver, getReceiverGateIndex(receiver));
+        sent++;
+    }
+
+    // delete the original frame
+    delete frame;
+    return sent;
+}
+
 void LtePhyBase::sendUnicast(LteAirFrame *frame)
 {
     UserControlInfo *ci = check_and_cast<UserControlInfo *>(
@@ -280,12 +361,6 @@ void LtePhyBase::sendUnicast(LteAirFrame *frame)
     // dest MacNodeId from control info
     MacNodeId dest = ci->getDestId();
     // destination node (UE, RELAY or ENODEB) omnet id
-    try {
-        binder_->getOmnetId(dest);
-    } catch (std::out_of_range& e) {
-        delete frame;
-        return;         // make sure that nodes that left the simulation do not send
-    }
     OmnetId destOmnetId = binder_->getOmnetId(dest);
     if (destOmnetId == 0){
         // destination node has left the simulation
@@ -137,6 +137,12 @@ class LtePhyBase : public ChannelAccess
     // last time that the node has transmitted (currently, used only by UEs)
     omnetpp::simtime_t lastActive_;
 
+    // copies of the control info of received broadcast/multicast frames, and copies
+    // avoided by reading the handover broadcasts through the shared control info
+    bool recordControlInfoCopies_;
+    unsigned long controlInfoCopies_;
+    unsigned long controlInfoCopiesAvoided_;
+
     public:
 
     /**
@@ -191,6 +197,11 @@ class LtePhyBase : public ChannelAccess
      */
     virtual void initialize(int stage) override;
 
+    /**
+     * Records the control info copy counters, if enabled
+     */
+    virtual void finish() override;
+
     virtual int numInitStages() const override {
         return std::max(inet::INITSTAGE_LAST+1, ChannelAccess::numInitStages());
     }
@@ -202,6 +213,12 @@ class LtePhyBase : public ChannelAccess
      */
     virtual void handleMessage(omnetpp::cMessage *msg) override;
 
+    /**
+     * Updates the radio position and notifies it to the binder,
+     * which keeps the spatial index of nodes
+     */
+    virtual void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, omnetpp::cObject *obj, omnetpp::cObject *details) override;
+
     /**
      * Sends a frame to all NICs in range.
      *
@@ -216,6 +233,16 @@ class LtePhyBase : public ChannelAccess
      */
     virtual void sendMulticast(LteAirFrame *frame);
 
+    /**
+     * Sends a frame to the UEs (and relays) within the given distance, using the
+     * spatial index of the binder instead of the channel control neighbor list
+     *
+     * Frames are sent with zero transmission delay.
+     *
+     * @return the number of receivers
+     */
+    virtual unsigned int sendBroadcastInRange(LteAirFrame *frame, double range);
+
     /**
      * Sends a frame uniquely to the dest specified in carried control info.
      *
@@ -303,7 +330,18 @@ class LtePhyBase : public ChannelAccess
      */
     int getReceiverGateIndex(const omnetpp::cModule*) const;
 
+    /**
+     * Processes a handover broadcast, whose control info is shared among all the receivers
+     * and must not be modified. Takes the ownership of the frame.
+     * The default implementation drops it, since only UEs handle handover broadcasts
+     */
+    virtual void handleHandoverBroadcast(LteAirFrame* frame, const UserControlInfo* lteInfo);
+
   public:
+    /*
+     * Returns the MacNodeId of the node
+     */
+    MacNodeId getMacNodeId() const { return nodeId_; }
     /*
      * Returns the current position of the node
      */
@@ -8,6 +8,7 @@
 //
 
 #include "stack/phy/layer/LtePhyEnb.h"
+#include "stack/phy/layer/LtePhyUe.h"
 #include "stack/phy/packet/LteFeedbackPkt.h"
 #include "stack/phy/das/DasFilter.h"
 #include "common/LteCommon.h"
@@ -21,11 +22,21 @@ LtePhyEnb::LtePhyEnb()
 {
     das_ = NULL;
     bdcStarter_ = NULL;
+    broadcastRange_ = -1;
+    bdcDelivered_ = 0;
+    bdcSkipped_ = 0;
+    abstractPhy_ = false;
+    abstractPhyTick_ = NULL;
+    abstractPdusDelivered_ = 0;
+    abstractBatches_ = 0;
 }
 
 LtePhyEnb::~LtePhyEnb()
 {
     cancelAndDelete(bdcStarter_);
+    cancelAndDelete(abstractPhyTick_);
+    for (unsigned int i = 0; i < abstractPdus_.size(); i++)
+        delete abstractPdus_[i].second;
     if(lteFeedbackComputation_){
         delete lteFeedbackComputation_;
         lteFeedbackComputation_ = NULL;
@@ -55,6 +66,16 @@ void LtePhyEnb::initialize(int stage)
         cellInfo_->channelUpdate(nodeId_, intuniform(1, binder_->phyPisaData.maxChannel2()));
         das_ = new DasFilter(this, binder_, cellInfo_->getRemoteAntennaSet(), 0);
 
+        abstractPhy_ = par("abstractPhy");
+        if (abstractPhy_)
+        {
+            abstractPhyTick_ = new cMessage("abstractPhyTick");
+            // delivered along with the air frames sent in the same TTI
+            abstractPhyTick_->setSchedulingPriority(airFramePriority_);
+            WATCH(abstractPdusDelivered_);
+            WATCH(abstractBatches_);
+        }
+
         WATCH(nodeType_);
         WATCH(das_);
     }
@@ -83,6 +104,9 @@ void LtePhyEnb::initialize(int stage)
         }
 
         bdcUpdateInterval_ = cellInfo_->par("broadcastMessageInterval");
+        broadcastRange_ = par("broadcastRange");
+        WATCH(bdcDelivered_);
+        WATCH(bdcSkipped_);
         if (bdcUpdateInterval_ != 0 && par("enableHandover").boolValue()) {
             // self message provoking the generation of a broadcast message
             bdcStarter_ = new cMessage("bdcStarter");
@@ -101,15 +125,122 @@ void LtePhyEnb::handleSelfMessage(cMessage *msg)
     {
         // send broadcast message
         LteAirFrame *f = createHandoverMessage();
-        sendBroadcast(f);
+        if (broadcastRange_ > 0)
+        {
+            // deliver only to the UEs that may hand over to this cell
+            unsigned int sent = sendBroadcastInRange(f, broadcastRange_);
+            unsigned int numUes = binder_->getNumUePositions();
+            bdcDelivered_ += sent;
+            bdcSkipped_ += (numUes > sent) ? numUes - sent : 0;
+        }
+        else
+            sendBroadcast(f);
         scheduleAt(NOW + bdcUpdateInterval_, msg);
     }
+    else if (msg == abstractPhyTick_)
+    {
+        deliverAbstractPdus();
+    }
     else
     {
         delete msg;
     }
 }
 
+void LtePhyEnb::finish()
+{
+    LtePhyBase::finish();
+
+    if (broadcastRange_ > 0)
+    {
+        recordScalar("broadcastDelivered", bdcDelivered_);
+        recordScalar("broadcastSkipped", bdcSkipped_);
+    }
+    if (abstractPhy_)
+    {
+        recordScalar("abstractPhyPdus", abstractPdusDelivered_);
+        recordScalar("abstractPhyBatches", abstractBatches_);
+    }
+}
+
+void LtePhyEnb::handleUpperMessage(cMessage* msg)
+{
+    if (abstractPhy_ && isAbstractPdu(check_and_cast<UserControlInfo*>(msg->getControlInfo())))
+    {
+        sendAbstractPdu(check_and_cast<cPacket*>(msg));
+        return;
+    }
+
+    LtePhyBase::handleUpperMessage(msg);
+}
+
+bool LtePhyEnb::isAbstractPdu(UserControlInfo* lteInfo)
+{
+    // control PDUs (H-ARQ feedback, grants, RAC responses, mode switch) always use air frames
+    if (lteInfo->getFrameType() != DATAPKT || lteInfo->getDirection() != DL || lteInfo->getIsBroadcast())
+        return false;
+
+    if (getNodeTypeById(lteInfo->getDestId()) != UE)
+        return false;
+
+    // DAS transmissions need the air frame to carry the remote units data
+    return lteInfo->getUserTxParams() != NULL && lteInfo->getUserTxParams()->readAntennaSet().size() <= 1;
+}
+
+void LtePhyEnb::sendAbstractPdu(cPacket* pkt)
+{
+    UserControlInfo* lteInfo = check_and_cast<UserControlInfo*>(pkt->getControlInfo());
+
+    // same fields as the air frame (see LtePhyBase::handleUpperMessage())
+    lteInfo->setCoord(getRadioPosition());
+    lteInfo->setTxPower(txPower_);
+
+    EV << "LtePhyEnb::sendAbstractPdu - PDU for " << lteInfo->getDestId() << " will be delivered at the next TTI" << endl;
+
+    abstractPdus_.push_back(std::make_pair(NOW, pkt));
+
+    // the PDU would reach the UE at the end of the air frame transmission. If the tick is
+    // already scheduled, it is due within this TTI and will re-arm for this PDU
+    if (!abstractPhyTick_->isScheduled())
+        scheduleAt(NOW + TTI, abstractPhyTick_);
+}
+
+void LtePhyEnb::deliverAbstractPdus()
+{
+    // the tick may fire in the same TTI as the MAC sends new PDUs (which are sent before
+    // the air frames are delivered): those must wait for the next TTI, like their air frames
+    unsigned int delivered = 0;
+    while (delivered < abstractPdus_.size() && abstractPdus_[delivered].first + TTI <= NOW)
+        delivered++;
+
+    EV << NOW << " LtePhyEnb::deliverAbstractPdus - delivering " << delivered << " PDUs" << endl;
+
+    if (delivered > 0)
+        abstractBatches_++;
+
+    for (unsigned int i = 0; i < delivered; i++)
+    {
+        cPacket* pkt = abstractPdus_[i].second;
+        MacNodeId destId = check_and_cast<UserControlInfo*>(pkt->getControlInfo())->getDestId();
+
+        if (binder_->getOmnetId(destId) == 0)
+        {
+            // destination node has left the simulation
+            delete pkt;
+            continue;
+        }
+
+        LtePhyUe* phy = check_and_cast<LtePhyUe*>(binder_->getPhyByMacNodeId(destId));
+        phy->receiveAbstractPdu(pkt);
+        abstractPdusDelivered_++;
+    }
+    abstractPdus_.erase(abstractPdus_.begin(), abstractPdus_.begin() + delivered);
+
+    // deliver the remaining PDUs one TTI after the earliest of them was sent
+    if (!abstractPdus_.empty())
+        scheduleAt(abstractPdus_.front().first + TTI, abstractPhyTick_);
+}
+
 bool LtePhyEnb::handleControlPkt(UserControlInfo* lteinfo, LteAirFrame* frame)
 {
     EV << "Received control pkt " << endl;
@@ -258,7 +389,8 @@ void LtePhyEnb::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame,
 
     //Apply analog model (pathloss)
     //Get snr for UL direction
-    std::vector<double> snr = channelModel_->getSINR(frame, lteinfo);
+    std::vector<double>& snr = sinrBuffer_;
+    channelModel_->computeSINR(frame, lteinfo, snr);
     FeedbackRequest req = lteinfo->feedbackReq;
     //Feedback computation
     fb_.clear();
@@ -317,7 +449,7 @@ void LtePhyEnb::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame,
             lteinfo->setDirection(DL);
 
             //Get snr for DL direction
-            snr = channelModel_->getSINR(frame, lteinfo);
+            channelModel_->computeSINR(frame, lteinfo, snr);
         }
         else
             pkt->setLteFeedbackDoubleVectorDl(fb_);
@@ -26,6 +26,33 @@ class LtePhyEnb : public LtePhyBase
     /** Self message to trigger broadcast message sending for handover purposes */
     omnetpp::cMessage *bdcStarter_;
 
+    /**
+     * If positive, broadcast messages are delivered only to the UEs within
+     * this distance (m), otherwise to all the nodes in range of the channel control
+     */
+    double broadcastRange_;
+
+    /** Broadcast messages delivered and not delivered to UEs due to the broadcast range */
+    unsigned long bdcDelivered_;
+    unsigned long bdcSkipped_;
+
+    /**
+     * If true, DL data PDUs are not sent as air frames: they are collected during
+     * the TTI and delivered to the PHY of the receiving UEs with a single event at
+     * the next TTI, where they are decoded as usual (see sendAbstractPdu())
+     */
+    bool abstractPhy_;
+
+    /** DL data PDUs not delivered yet, with the time they were sent at, in sending order */
+    std::vector<std::pair<omnetpp::simtime_t, omnetpp::cPacket*> > abstractPdus_;
+
+    /** Self message delivering the DL data PDUs sent one TTI before */
+    omnetpp::cMessage* abstractPhyTick_;
+
+    /** PDUs and batches delivered without air frames */
+    unsigned long abstractPdusDelivered_;
+    unsigned long abstractBatches_;
+
     /**
      * Pointer to the DAS Filter: used to call das function
      * when receiving broadcasts and to retrieve physical
@@ -34,11 +61,15 @@ class LtePhyEnb : public LtePhyBase
     DasFilter* das_;
     //Used for PisaPhy feedback generator
     LteFeedbackDoubleVector fb_;
+    // SINR of the link the feedback is computed for, reused across feedback requests
+    std::vector<double> sinrBuffer_;
 
     virtual void initialize(int stage);
+    virtual void finish();
 
     virtual void handleSelfMessage(omnetpp::cMessage *msg);
     virtual void handleAirFrame(omnetpp::cMessage* msg);
+    virtual void handleUpperMessage(omnetpp::cMessage* msg);
     bool handleControlPkt(UserControlInfo* lteinfo, LteAirFrame* frame);
     void handleFeedbackPkt(UserControlInfo* lteinfo, LteAirFrame* frame);
     virtual void requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame, LteFeedbackPkt* pkt);
@@ -50,6 +81,14 @@ class LtePhyEnb : public LtePhyBase
     LteFeedbackComputation* getFeedbackComputationFromName(std::string name, ParameterMap& params);
     void initializeFeedbackComputation();
 
+    /**
+     * Abstract PHY support: returns true if the PDU can be delivered without an air frame,
+     * i.e. it is a unicast DL data PDU for a UE, not transmitted by remote antennas
+     */
+    bool isAbstractPdu(UserControlInfo* lteInfo);
+    void sendAbstractPdu(omnetpp::cPacket* pkt);
+    void deliverAbstractPdus();
+
   public:
     LtePhyEnb();
     virtual ~LtePhyEnb();
@@ -41,7 +41,8 @@ void LtePhyEnbD2D::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame,
 
     //Apply analog model (pathloss)
     //Get snr for UL direction
-    std::vector<double> snr = channelModel_->getSINR(frame, lteinfo);
+    std::vector<double>& snr = sinrBuffer_;
+    channelModel_->computeSINR(frame, lteinfo, snr);
     FeedbackRequest req = lteinfo->feedbackReq;
     //Feedback computation
     fb_.clear();
@@ -97,7 +98,7 @@ void LtePhyEnbD2D::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame,
             lteinfo->setDirection(DL);
 
             //Get snr for DL direction
-            snr = channelModel_->getSINR(frame, lteinfo);
+            channelModel_->computeSINR(frame, lteinfo, snr);
 
             dir = DL;
         }
@@ -121,7 +122,7 @@ void LtePhyEnbD2D::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame,
                          Coord peerCoord = (*it)->phy->getCoord();
 
                          // get SINR for this link
-                         snr = channelModel_->getSINR_D2D(frame, lteinfo, peerId, peerCoord, nodeId_);
+                         channelModel_->computeSINR_D2D(frame, lteinfo, peerId, peerCoord, nodeId_, snr);
 
                          // compute the feedback for this link
                          fb_ = lteFeedbackComputation_->computeFeedback(type, rbtype, txmode,
@@ -46,6 +46,13 @@ void LtePhyRelay::initialize(int stage)
             scheduleAt(NOW, bdcStarter_);
         }
     }
+    else
+    {
+        // the relay is stored in the spatial index of the binder at the last stage
+        if (stage == inet::INITSTAGE_LAST)
+            nodeId_ = getAncestorPar("macNodeId");
+        LtePhyBase::initialize(stage);
+    }
 }
 
 void LtePhyRelay::handleSelfMessage(cMessage *msg)
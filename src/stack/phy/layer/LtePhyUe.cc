@@ -38,6 +38,7 @@ void LtePhyUe::initialize(int stage)
         nodeType_ = UE;
         useBattery_ = false;  // disabled
         enableHandover_ = par("enableHandover");
+        handoverSnrOnly_ = par("handoverSnrOnly");
         handoverLatency_ = par("handoverLatency").doubleValue();
         dynamicCellAssociation_ = par("dynamicCellAssociation");
         currentMasterRssi_ = 0;
@@ -181,9 +182,8 @@ void LtePhyUe::handleSelfMessage(cMessage *msg)
     }
 }
 
-void LtePhyUe::handoverHandler(LteAirFrame* frame, UserControlInfo* lteInfo)
+void LtePhyUe::handoverHandler(LteAirFrame* frame, const UserControlInfo* lteInfo)
 {
-    lteInfo->setDestId(nodeId_);
     if (!enableHandover_)
     {
         // Even if handover is not enabled, this call is necessary
@@ -195,24 +195,24 @@ void LtePhyUe::handoverHandler(LteAirFrame* frame, UserControlInfo* lteInfo)
         }
 
         delete frame;
-        delete lteInfo;
         return;
     }
 
-    frame->setControlInfo(lteInfo);
     double rssi;
 
     if (getNodeTypeById(lteInfo->getSourceId()) == ENODEB && lteInfo->getSourceId() == masterId_)
     {
-        // Broadcast message from my master enb
-        rssi = das_->receiveBroadcast(frame, lteInfo);
+        // Broadcast message from my master enb, measured as the other cells
+        rssi = das_->receiveBroadcast(frame, lteInfo, handoverSnrOnly_);
     }
     else
     {
         // Broadcast message from relay or not-master enb
         std::vector<double>::iterator it;
         rssi = 0;
-        std::vector<double> rssiV = channelModel_->getSINR(frame, lteInfo);
+        std::vector<double> rssiV = handoverSnrOnly_ ?
+            channelModel_->getSNR(frame, lteInfo) :
+            channelModel_->getSINR(frame, lteInfo);
         for (it = rssiV.begin(); it != rssiV.end(); ++it)
             rssi += *it;
         rssi /= rssiV.size();
@@ -260,6 +260,27 @@ void LtePhyUe::handoverHandler(LteAirFrame* frame, UserControlInfo* lteInfo)
     delete frame;
 }
 
+void LtePhyUe::handleHandoverBroadcast(LteAirFrame* frame, const UserControlInfo* lteInfo)
+{
+    connectedNodeId_ = masterId_;
+
+    if (binder_->getOmnetId(lteInfo->getSourceId()) == 0)
+    {
+        // source has left the simulation
+        delete frame;
+        return;
+    }
+
+    // check if handover is already in process
+    if (handoverTrigger_ != NULL && handoverTrigger_->isScheduled())
+    {
+        delete frame;
+        return;
+    }
+
+    handoverHandler(frame, lteInfo);
+}
+
 void LtePhyUe::triggerHandover()
 {
     // TODO: remove asserts after testing
@@ -319,7 +340,7 @@ void LtePhyUe::doHandover()
     hysteresisTh_ = updateHysteresisTh(currentMasterRssi_);
 
     // update cellInfo
-    LteMacEnb* newMacEnb =  check_and_cast<LteMacEnb*>(getSimulation()->getModule(binder_->getOmnetId(candidateMasterId_))->getSubmodule("lteNic")->getSubmodule("mac"));
+    LteMacEnb* newMacEnb =  check_and_cast<LteMacEnb*>(binder_->getMacFromMacNodeId(candidateMasterId_));
     LteCellInfo* newCellInfo = newMacEnb->getCellInfo();
     cellInfo_->detachUser(nodeId_);
     newCellInfo->attachUser(nodeId_);
@@ -378,6 +399,7 @@ void LtePhyUe::handleAirFrame(cMessage* msg)
         }
 
         handoverHandler(frame, lteInfo);
+        delete lteInfo;
         return;
     }
 
@@ -481,6 +503,53 @@ void LtePhyUe::handleAirFrame(cMessage* msg)
     updateDisplayString();
 }
 
+void LtePhyUe::receiveAbstractPdu(cPacket* pkt)
+{
+    Enter_Method_Silent("receiveAbstractPdu()");
+    take(pkt);
+
+    UserControlInfo* lteInfo = check_and_cast<UserControlInfo*>(pkt->removeControlInfo());
+    connectedNodeId_ = masterId_;
+
+    // PDU scheduled by the old master during handover (see handleAirFrame())
+    if (lteInfo->getDestId() != nodeId_ || lteInfo->getSourceId() != masterId_)
+    {
+        EV << "WARNING: PDU from an old master during handover: deleted " << endl;
+        delete lteInfo;
+        delete pkt;
+        return;
+    }
+
+    if ((lteInfo->getUserTxParams()) != NULL)
+    {
+        int cw = lteInfo->getCw();
+        if (lteInfo->getUserTxParams()->readCqiVector().size() == 1)
+            cw = 0;
+        double cqi = lteInfo->getUserTxParams()->readCqiVector()[cw];
+        emit(averageCqiDl_, cqi);
+    }
+
+    // apply decider to received packet. The channel model only needs the control info
+    bool result = channelModel_->isCorrupted(NULL, lteInfo);
+
+    // update statistics
+    if (result)
+        numAirFrameReceived_++;
+    else
+        numAirFrameNotReceived_++;
+
+    EV << "Handled abstract PDU with result " << ( result ? "RECEIVED" : "NOT RECEIVED" ) << endl;
+
+    // attach the decider result to the packet as control info
+    lteInfo->setDeciderResult(result);
+    pkt->setControlInfo(lteInfo);
+
+    send(pkt, upperGateOut_);
+
+    if (getEnvir()->isGUI())
+        updateDisplayString();
+}
+
 void LtePhyUe::handleUpperMessage(cMessage* msg)
 {
 //    if (useBattery_) {
@@ -498,7 +567,7 @@ void LtePhyUe::handleUpperMessage(cMessage* msg)
     if (lteInfo->getFrameType() == DATAPKT && (channelModel_->isUplinkInterferenceEnabled() || channelModel_->isD2DInterferenceEnabled()))
     {
         // Store the RBs used for data transmission to the binder (for UL interference computation)
-        RbMap rbMap = lteInfo->getGrantedBlocks();
+        const RbMap& rbMap = lteInfo->getGrantedBlocks();
         Remote antenna = MACRO;  // TODO fix for multi-antenna
         binder_->storeUlTransmissionMap(antenna, rbMap, nodeId_, mac_->getMacCellId(), this, UL);
     }
@@ -619,6 +688,8 @@ void LtePhyUe::sendFeedback(LteFeedbackDoubleVector fbDl, LteFeedbackDoubleVecto
 
 void LtePhyUe::finish()
 {
+    LtePhyBase::finish();
+
     if (getSimulation()->getSimulationStage() != CTX_FINISH)
     {
         // do this only at deletion of the module during the simulation
@@ -73,6 +73,12 @@ class LtePhyUe : public LtePhyBase
      */
     bool enableHandover_;
 
+    /**
+     * If true, the RSSI of broadcast messages, from the master too,
+     * is computed without interference (see LteChannelModel::getSNR())
+     */
+    bool handoverSnrOnly_;
+
     /**
      * Pointer to the DAS Filter: used to call das function
      * when receiving broadcasts and to retrieve physical
@@ -115,7 +121,13 @@ class LtePhyUe : public LtePhyBase
      */
     double updateHysteresisTh(double v);
 
-    void handoverHandler(LteAirFrame* frame, UserControlInfo* lteInfo);
+    /**
+     * Measures the RSSI of a handover broadcast and possibly starts the handover.
+     * Deletes the frame, while the control info is only read
+     */
+    void handoverHandler(LteAirFrame* frame, const UserControlInfo* lteInfo);
+
+    virtual void handleHandoverBroadcast(LteAirFrame* frame, const UserControlInfo* lteInfo) override;
 
     void deleteOldBuffers(MacNodeId masterId);
 
@@ -130,6 +142,13 @@ class LtePhyUe : public LtePhyBase
      * Send Feedback, called by feedback generator in DL
      */
     virtual void sendFeedback(LteFeedbackDoubleVector fbDl, LteFeedbackDoubleVector fbUl, FeedbackRequest req);
+
+    /**
+     * Receives a DL data PDU sent by the master without an air frame (see the
+     * abstractPhy parameter of LtePhyEnb): applies the decider at once and
+     * sends the PDU up with the result, as handleAirFrame() does
+     */
+    void receiveAbstractPdu(omnetpp::cPacket* pkt);
     MacNodeId getMasterId() const
     {
         return masterId_;
@@ -105,6 +105,7 @@ void LtePhyUeD2D::handleAirFrame(cMessage* msg)
         }
 
         handoverHandler(frame, lteInfo);
+        delete lteInfo;
         return;
     }
 
@@ -261,7 +262,7 @@ void LtePhyUeD2D::handleUpperMessage(cMessage* msg)
     if (lteInfo->getFrameType() == DATAPKT && (channelModel_->isUplinkInterferenceEnabled() || channelModel_->isD2DInterferenceEnabled()))
     {
         // Store the RBs used for data transmission to the binder (for UL interference computation)
-        RbMap rbMap = lteInfo->getGrantedBlocks();
+        const RbMap& rbMap = lteInfo->getGrantedBlocks();
         Remote antenna = MACRO;  // TODO fix for multi-antenna
         Direction dir = (Direction)lteInfo->getDirection();
         binder_->storeUlTransmissionMap(antenna, rbMap, nodeId_, mac_->getMacCellId(), this, dir);
@@ -333,17 +334,16 @@ void LtePhyUeD2D::storeAirFrame(LteAirFrame* newFrame)
         rsrpVector = channelModel_->getRSRP_D2D(newFrame, newInfo, nodeId_, myCoord);
 
         // get the average RSRP on the RBs allocated for the transmission
-        RbMap rbmap = newInfo->getGrantedBlocks();
-        RbMap::iterator it;
-        std::map<Band, unsigned int>::iterator jt;
+        const RbMap& rbmap = newInfo->getGrantedBlocks();
         //for each Remote unit used to transmit the packet
-        for (it = rbmap.begin(); it != rbmap.end(); ++it)
+        for (unsigned int r = 0; r < NUM_ANTENNAS; ++r)
         {
+            if (!rbmap.hasRemote((Remote)r))
+                continue;
             //for each logical band used to transmit the packet
-            for (jt = it->second.begin(); jt != it->second.end(); ++jt)
+            for (Band band = 0; band < rbmap.getNumBands(); ++band)
             {
-                Band band = jt->first;
-                if (jt->second == 0) // this Rb is not allocated
+                if (rbmap.get((Remote)r, band) == 0) // this Rb is not allocated
                     continue;
 
                 sum += rsrpVector.at(band);
@@ -536,4 +536,6 @@ void LtePhyUeD2D::finish()
 
         LtePhyUe::finish();
     }
+    else
+        LtePhyBase::finish();
 }
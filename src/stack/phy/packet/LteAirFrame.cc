@@ -11,9 +11,46 @@
 
 void LteAirFrame::addRemoteUnitPhyDataVector(RemoteUnitPhyData data)
 {
-    remoteUnitPhyDataVector.push_back(data);
+    if (!remoteUnitPhyDataVector)
+        remoteUnitPhyDataVector = std::make_shared<RemoteUnitPhyDataVector>();
+    else if (remoteUnitPhyDataVector.use_count() > 1)
+        remoteUnitPhyDataVector = std::make_shared<RemoteUnitPhyDataVector>(*remoteUnitPhyDataVector);
+
+    remoteUnitPhyDataVector->push_back(data);
 }
 RemoteUnitPhyDataVector LteAirFrame::getRemoteUnitPhyDataVector()
 {
-    return remoteUnitPhyDataVector;
+    if (!remoteUnitPhyDataVector)
+        return RemoteUnitPhyDataVector();
+    return *remoteUnitPhyDataVector;
+}
+
+void LteAirFrame::shareControlInfo()
+{
+    if (getControlInfo() == NULL)
+        return;
+
+    UserControlInfo* info = omnetpp::check_and_cast<UserControlInfo*>(removeControlInfo());
+    sharedControlInfo = std::make_shared<SharedControlInfo>(info);
+}
+
+bool LteAirFrame::restoreControlInfo()
+{
+    if (!sharedControlInfo)
+        return false;
+
+    UserControlInfo* info;
+    bool duplicated = !isLastSharedCopy();
+    if (!duplicated)
+    {
+        // this is the last copy, no need to duplicate
+        info = sharedControlInfo->info;
+        sharedControlInfo->info = NULL;
+    }
+    else
+        info = sharedControlInfo->info->dup();
+
+    sharedControlInfo.reset();
+    setControlInfo(info);
+    return duplicated;
 }
@@ -10,6 +10,7 @@
 #ifndef _LTE_LTEAIRFRAME_H_
 #define _LTE_LTEAIRFRAME_H_
 
+#include <memory>
 #include <omnetpp.h>
 
 #include "common/LteCommon.h"
@@ -19,7 +20,23 @@
 class LteAirFrame : public LteAirFrame_Base
 {
   protected:
-    RemoteUnitPhyDataVector remoteUnitPhyDataVector;
+    /*
+     * Control info of a broadcast/multicast frame, shared among all its copies.
+     * Receivers that only read it (handover broadcasts) use it in place, see
+     * getSharedControlInfo(). The others attach a duplicate of it, except for the
+     * last copy that is received, which takes its ownership (see restoreControlInfo())
+     */
+    struct SharedControlInfo
+    {
+        UserControlInfo* info;
+        SharedControlInfo(UserControlInfo* i) : info(i) {}
+        ~SharedControlInfo() { delete info; }
+    };
+    std::shared_ptr<SharedControlInfo> sharedControlInfo;
+
+    // shared among the copies of the frame, copied before being modified
+    std::shared_ptr<RemoteUnitPhyDataVector> remoteUnitPhyDataVector;
+
     public:
     LteAirFrame(const char *name = NULL, int kind = 0) :
         LteAirFrame_Base(name, kind)
@@ -34,6 +51,7 @@ class LteAirFrame : public LteAirFrame_Base
     {
         LteAirFrame_Base::operator=(other);
         this->remoteUnitPhyDataVector = other.remoteUnitPhyDataVector;
+        this->sharedControlInfo = other.sharedControlInfo;
 
         // copy the attached control info, if any
         if (other.getControlInfo() != NULL)
@@ -51,6 +69,36 @@ class LteAirFrame : public LteAirFrame_Base
     // ADD CODE HERE to redefine and implement pure virtual functions from LteAirFrame_Base
     void addRemoteUnitPhyDataVector(RemoteUnitPhyData data);
     RemoteUnitPhyDataVector getRemoteUnitPhyDataVector();
+
+    /**
+     * Detaches the control info from the frame, so that the copies
+     * obtained with dup() share it instead of duplicating it.
+     * To be called before sending the frame to multiple receivers
+     */
+    void shareControlInfo();
+
+    /**
+     * Returns the control info shared among the copies of the frame,
+     * NULL if it is not shared. It must not be modified
+     */
+    const UserControlInfo* getSharedControlInfo() const
+    {
+        return sharedControlInfo ? sharedControlInfo->info : NULL;
+    }
+
+    /**
+     * Returns true if no other copy of the frame refers to the shared control info
+     */
+    bool isLastSharedCopy() const { return sharedControlInfo.use_count() == 1; }
+
+    /**
+     * Attaches the shared control info (if any) to the frame, for receivers
+     * that modify it or pass it up the stack.
+     * To be called upon reception, before accessing the control info
+     *
+     * @return true if the control info has been duplicated
+     */
+    bool restoreControlInfo();
 };
 
 Register_Class(LteAirFrame);
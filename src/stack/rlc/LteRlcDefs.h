@@ -106,6 +106,56 @@ struct RlcWindowDesc
     }
 };
 
+/*!
+ * Ring buffer indexing of the RLC windows
+ *
+ * The per-PDU state of a window (buffered PDUs, received/discarded flags) is
+ * stored in a ring of power-of-two size, indexed by the position in the window
+ * modulo the ring size. Moving the window by n positions only clears the n
+ * leaving slots and advances the head, instead of shifting the whole window.
+ */
+struct RlcWindowRing
+{
+  public:
+    //! Slot of the first position of the window
+    unsigned int head_;
+    //! Ring size minus one
+    unsigned int mask_;
+
+    RlcWindowRing()
+    {
+        head_ = 0;
+        mask_ = 0;
+    }
+
+    //! Sets the ring size to the smallest power of two not lower than the window size
+    void init(unsigned int windowSize)
+    {
+        unsigned int size = 1;
+        while (size < windowSize)
+            size <<= 1;
+        head_ = 0;
+        mask_ = size - 1;
+    }
+
+    unsigned int size() const
+    {
+        return mask_ + 1;
+    }
+
+    //! Slot of the given position of the window
+    unsigned int slot(unsigned int pos) const
+    {
+        return (head_ + pos) & mask_;
+    }
+
+    //! Moves the first position of the window forward by pos positions
+    void advance(unsigned int pos)
+    {
+        head_ = (head_ + pos) & mask_;
+    }
+};
+
 /*!
  * Move Receiver Window command descriptor
  */
@@ -0,0 +1,54 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/rlc/LteRlcEntity.h"
+
+Define_Module(LteRlcEntityHost);
+
+using namespace omnetpp;
+
+LteRlcEntity::LteRlcEntity(cSimpleModule* module)
+{
+    module_ = module;
+    owner_ = check_and_cast<LteRlcEntityOwner*>(module);
+}
+
+bool LteRlcEntity::isPooled() const
+{
+    return dynamic_cast<LteRlcEntityHost*>(module_) == NULL;
+}
+
+LteRlcEntityHost::~LteRlcEntityHost()
+{
+    delete entity_;
+}
+
+void LteRlcEntityHost::setEntity(LteRlcEntity* entity)
+{
+    Enter_Method_Silent("setEntity()");
+
+    if (entity->getModule() != this)
+        throw cRuntimeError("LteRlcEntityHost::setEntity - entity %s does not run in this module", entity->getName());
+
+    entity_ = entity;
+    entity_->initialize();
+}
+
+void LteRlcEntityHost::handleMessage(cMessage* msg)
+{
+    entity_->handleMessage(msg);
+}
+
+void LteRlcEntityProfile::record(cSimpleModule* module) const
+{
+    module->recordScalar("rlcEntitiesCreated", created_);
+    module->recordScalar("rlcEntityCreationTime", (created_ > 0) ? creationTime_ / created_ : 0.0, "s");
+    module->recordScalar("rlcEntitiesDeleted", deleted_);
+    module->recordScalar("rlcEntityDeletionTime", (deleted_ > 0) ? deletionTime_ / deleted_ : 0.0, "s");
+}
@@ -0,0 +1,236 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTERLCENTITY_H_
+#define _LTE_LTERLCENTITY_H_
+
+#include <omnetpp.h>
+#include <vector>
+#include <chrono>
+
+/**
+ * Counterpart of Enter_Method for the RLC entities: switches the context
+ * to the module the entity runs in
+ */
+#define Enter_Entity_Method  omnetpp::cMethodCallContextSwitcher __ctx(module_); __ctx.methodCall
+
+/**
+ * Interface of the modules RLC entities run in
+ */
+class LteRlcEntityOwner
+{
+  public:
+    virtual ~LteRlcEntityOwner() {}
+
+    //* takes ownership of an object on behalf of an entity
+    virtual void takeObj(omnetpp::cOwnedObject* obj) = 0;
+
+    //* drops ownership of an object on behalf of an entity
+    virtual void dropObj(omnetpp::cOwnedObject* obj) = 0;
+};
+
+/**
+ * @class LteRlcEntity
+ * @brief Base class of the RLC UM and AM entities
+ *
+ * The RLC entities (UmTxEntity, UmRxEntity, AmTxQueue and AmRxQueue) are plain
+ * objects running in the context of a module, which schedules their timers,
+ * owns their packets and provides their parameters:
+ *
+ * - by default, each entity runs in its own submodule of the RLC (LteRlcEntityHost),
+ *   created when the flow is detected and deleted on handover;
+ * - when the pooledEntities parameter of the RLC UM/AM module is set, entities run
+ *   in the RLC UM/AM module itself, which dispatches their timers through the
+ *   context pointer of the timer messages and recycles them via a LteRlcEntityPool.
+ */
+class LteRlcEntity : public omnetpp::cNamedObject
+{
+  protected:
+
+    // module the entity runs in
+    omnetpp::cSimpleModule* module_;
+
+    // the same module, seen as the owner of the packets of the entity
+    LteRlcEntityOwner* owner_;
+
+    // ownership of packets is held by the module the entity runs in
+    void take(omnetpp::cOwnedObject* obj) { owner_->takeObj(obj); }
+    void drop(omnetpp::cOwnedObject* obj) { owner_->dropObj(obj); }
+
+    omnetpp::cPar& par(const char* name) { return module_->par(name); }
+
+  public:
+    LteRlcEntity(omnetpp::cSimpleModule* module);
+    virtual ~LteRlcEntity() {}
+
+    omnetpp::cSimpleModule* getModule() const { return module_; }
+
+    /**
+     * Returns true if the entity runs in the RLC UM/AM module rather than
+     * in its own submodule
+     */
+    bool isPooled() const;
+
+    /**
+     * (Re)initializes the entity, reading its parameters from
+     * the module it runs in
+     */
+    virtual void initialize() = 0;
+
+    /**
+     * Handles the timers of the entity
+     */
+    virtual void handleMessage(omnetpp::cMessage* msg) {}
+
+    /**
+     * Deletes the buffered packets and stops the timers,
+     * so that the entity can be initialized again
+     */
+    virtual void clear() = 0;
+};
+
+/**
+ * @class LteRlcEntityHost
+ * @brief Submodule hosting a RLC entity
+ *
+ * Module type of the UmTxEntity, UmRxEntity, AmTxQueue and AmRxQueue NED modules.
+ * It provides the parameters of the entity, receives its timers and deletes it
+ * when the module is deleted.
+ */
+class LteRlcEntityHost : public omnetpp::cSimpleModule, public LteRlcEntityOwner
+{
+  protected:
+    LteRlcEntity* entity_;
+
+    virtual void handleMessage(omnetpp::cMessage* msg) override;
+
+  public:
+    LteRlcEntityHost()
+    {
+        entity_ = NULL;
+    }
+    virtual ~LteRlcEntityHost();
+
+    /**
+     * Sets the hosted entity and initializes it within the context of this module
+     */
+    void setEntity(LteRlcEntity* entity);
+    LteRlcEntity* getEntity() { return entity_; }
+
+    virtual void takeObj(omnetpp::cOwnedObject* obj) override { take(obj); }
+    virtual void dropObj(omnetpp::cOwnedObject* obj) override { drop(obj); }
+};
+
+/**
+ * @class LteRlcEntityPool
+ * @brief Pool of RLC entities running in the RLC UM/AM module
+ *
+ * Released entities are cleared and kept for reuse, so that flows created
+ * on handover and D2D mode switches do not allocate new entities.
+ */
+template <typename T>
+class LteRlcEntityPool
+{
+    // the module entities run in
+    omnetpp::cSimpleModule* module_;
+
+    // entities available for reuse
+    std::vector<T*> free_;
+
+    // statistics
+    unsigned int allocated_;
+    unsigned int reused_;
+
+  public:
+    LteRlcEntityPool()
+    {
+        module_ = NULL;
+        allocated_ = 0;
+        reused_ = 0;
+    }
+
+    ~LteRlcEntityPool()
+    {
+        for (unsigned int i = 0; i < free_.size(); i++)
+            delete free_[i];
+    }
+
+    void setModule(omnetpp::cSimpleModule* module) { module_ = module; }
+
+    /**
+     * Returns an entity with the given name, not yet initialized
+     */
+    T* acquire(const char* name)
+    {
+        T* entity;
+        if (free_.empty())
+        {
+            entity = new T(module_);
+            allocated_++;
+        }
+        else
+        {
+            entity = free_.back();
+            free_.pop_back();
+            reused_++;
+        }
+        entity->setName(name);
+        return entity;
+    }
+
+    void release(T* entity)
+    {
+        entity->clear();
+        free_.push_back(entity);
+    }
+
+    unsigned int getAllocated() const { return allocated_; }
+    unsigned int getReused() const { return reused_; }
+    unsigned int getFree() const { return free_.size(); }
+};
+
+/**
+ * Wall-clock cost of creating and deleting the RLC entities of a RLC UM/AM
+ * module (see the entityProfiling parameter)
+ */
+class LteRlcEntityProfile
+{
+    unsigned int created_;
+    unsigned int deleted_;
+    double creationTime_;
+    double deletionTime_;
+
+  public:
+    LteRlcEntityProfile()
+    {
+        created_ = 0;
+        deleted_ = 0;
+        creationTime_ = 0;
+        deletionTime_ = 0;
+    }
+
+    void addCreation(std::chrono::steady_clock::duration elapsed)
+    {
+        created_++;
+        creationTime_ += std::chrono::duration<double>(elapsed).count();
+    }
+
+    void addDeletion(std::chrono::steady_clock::duration elapsed)
+    {
+        deleted_++;
+        deletionTime_ += std::chrono::duration<double>(elapsed).count();
+    }
+
+    /**
+     * Records the profiling results as scalars of the given module
+     */
+    void record(omnetpp::cSimpleModule* module) const;
+};
+
+#endif
@@ -17,6 +17,106 @@ Define_Module(LteRlcAm);
 
 using namespace omnetpp;
 
+LteRlcAm::~LteRlcAm()
+{
+    // pooled buffers are owned by this module
+    if (pooledEntities_)
+    {
+        AmTxBuffers::iterator tit = txBuffers_.begin();
+        for (; tit != txBuffers_.end(); ++tit)
+            delete tit->second;
+        AmRxBuffers::iterator rit = rxBuffers_.begin();
+        for (; rit != rxBuffers_.end(); ++rit)
+            delete rit->second;
+    }
+}
+
+AmTxQueue* LteRlcAm::createTxBuffer(const char* name)
+{
+    std::chrono::steady_clock::time_point start;
+    if (entityProfiling_)
+        start = std::chrono::steady_clock::now();
+
+    AmTxQueue* txbuf;
+    if (pooledEntities_)
+    {
+        txbuf = txBufferPool_.acquire(name);
+        txbuf->initialize();
+    }
+    else
+    {
+        cModuleType* moduleType = cModuleType::get("lte.stack.rlc.AmTxQueue");
+        LteRlcEntityHost* host = check_and_cast<LteRlcEntityHost *>(
+            moduleType->createScheduleInit(name, getParentModule()));
+        txbuf = new AmTxQueue(host);
+        txbuf->setName(name);
+        host->setEntity(txbuf);
+    }
+
+    if (entityProfiling_)
+        entityProfile_.addCreation(std::chrono::steady_clock::now() - start);
+
+    return txbuf;
+}
+
+AmRxQueue* LteRlcAm::createRxBuffer(const char* name)
+{
+    std::chrono::steady_clock::time_point start;
+    if (entityProfiling_)
+        start = std::chrono::steady_clock::now();
+
+    AmRxQueue* rxbuf;
+    if (pooledEntities_)
+    {
+        rxbuf = rxBufferPool_.acquire(name);
+        rxbuf->initialize();
+    }
+    else
+    {
+        cModuleType* moduleType = cModuleType::get("lte.stack.rlc.AmRxQueue");
+        LteRlcEntityHost* host = check_and_cast<LteRlcEntityHost *>(
+            moduleType->createScheduleInit(name, getParentModule()));
+        rxbuf = new AmRxQueue(host);
+        rxbuf->setName(name);
+        host->setEntity(rxbuf);
+    }
+
+    if (entityProfiling_)
+        entityProfile_.addCreation(std::chrono::steady_clock::now() - start);
+
+    return rxbuf;
+}
+
+void LteRlcAm::deleteTxBuffer(AmTxQueue* txbuf)
+{
+    std::chrono::steady_clock::time_point start;
+    if (entityProfiling_)
+        start = std::chrono::steady_clock::now();
+
+    if (pooledEntities_)
+        txBufferPool_.release(txbuf);
+    else
+        txbuf->getModule()->deleteModule();    // the host deletes the buffer
+
+    if (entityProfiling_)
+        entityProfile_.addDeletion(std::chrono::steady_clock::now() - start);
+}
+
+void LteRlcAm::deleteRxBuffer(AmRxQueue* rxbuf)
+{
+    std::chrono::steady_clock::time_point start;
+    if (entityProfiling_)
+        start = std::chrono::steady_clock::now();
+
+    if (pooledEntities_)
+        rxBufferPool_.release(rxbuf);
+    else
+        rxbuf->getModule()->deleteModule();    // the host deletes the buffer
+
+    if (entityProfiling_)
+        entityProfile_.addDeletion(std::chrono::steady_clock::now() - start);
+}
+
 AmTxQueue*
 LteRlcAm::getTxBuffer(FlowControlInfo* lteInfo)
 {
@@ -35,13 +135,10 @@ LteRlcAm::getTxBuffer(FlowControlInfo* lteInfo)
         // FIXME HERE
 
         buf << "AmTxQueue Lcid: " << lcid;
-        cModuleType* moduleType = cModuleType::get("lte.stack.rlc.AmTxQueue");
-        AmTxQueue* txbuf = check_and_cast<AmTxQueue *>(
-            moduleType->createScheduleInit(buf.str().c_str(),
-                getParentModule()));
+        AmTxQueue* txbuf = createTxBuffer(buf.str().c_str());
         txBuffers_[cid] = txbuf; // Add to tx_buffers map
 
-        EV << NOW << " LteRlcAm : Added new AmTxBuffer: " << txbuf->getId()
+        EV << NOW << " LteRlcAm : Added new AmTxBuffer: " << txbuf->getName()
            << " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         return txbuf;
@@ -49,7 +146,7 @@ LteRlcAm::getTxBuffer(FlowControlInfo* lteInfo)
     else
     {
         // Found
-        EV << NOW << " LteRlcAm : Using old AmTxBuffer: " << it->second->getId()
+        EV << NOW << " LteRlcAm : Using old AmTxBuffer: " << it->second->getName()
            << " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         return it->second;
@@ -68,13 +165,10 @@ LteRlcAm::getRxBuffer(MacNodeId nodeId, LogicalCid lcid)
         // Not found: create
         std::stringstream buf;
         buf << "AmRxQueue Lcid: " << lcid;
-        cModuleType* moduleType = cModuleType::get("lte.stack.rlc.AmRxQueue");
-        AmRxQueue* rxbuf = check_and_cast<AmRxQueue *>(
-            moduleType->createScheduleInit(buf.str().c_str(),
-                getParentModule()));
+        AmRxQueue* rxbuf = createRxBuffer(buf.str().c_str());
         rxBuffers_[cid] = rxbuf; // Add to rx_buffers map
 
-        EV << NOW << " LteRlcAm : Added new AmRxBuffer: " << rxbuf->getId()
+        EV << NOW << " LteRlcAm : Added new AmRxBuffer: " << rxbuf->getName()
            << " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         return rxbuf;
@@ -82,7 +176,7 @@ LteRlcAm::getRxBuffer(MacNodeId nodeId, LogicalCid lcid)
     else
     {
         // Found
-        EV << NOW << " LteRlcAm : Using old AmRxBuffer: " << it->second->getId()
+        EV << NOW << " LteRlcAm : Using old AmRxBuffer: " << it->second->getName()
            << " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         return it->second;
@@ -216,7 +310,7 @@ void LteRlcAm::deleteQueues(MacNodeId nodeId)
     {
         if (MacCidToNodeId(tit->first) == nodeId)
         {
-            delete tit->second; // Delete Queue
+            deleteTxBuffer(tit->second); // Delete Queue
             txBuffers_.erase(tit++); // Delete Elem
         }
         else
@@ -228,7 +322,7 @@ void LteRlcAm::deleteQueues(MacNodeId nodeId)
     {
         if (MacCidToNodeId(rit->first) == nodeId)
         {
-            delete rit->second; // Delete Queue
+            deleteRxBuffer(rit->second); // Delete Queue
             rxBuffers_.erase(rit++); // Delete Elem
         }
         else
@@ -248,10 +342,23 @@ void LteRlcAm::initialize()
     up_[OUT] = gate("AM_Sap_up$o");
     down_[IN] = gate("AM_Sap_down$i");
     down_[OUT] = gate("AM_Sap_down$o");
+
+    pooledEntities_ = par("pooledEntities");
+    entityProfiling_ = par("entityProfiling");
+    txBufferPool_.setModule(this);
+    rxBufferPool_.setModule(this);
 }
 
 void LteRlcAm::handleMessage(cMessage* msg)
 {
+    if (msg->isSelfMessage())
+    {
+        // timer of a pooled buffer
+        LteRlcEntity* entity = static_cast<LteRlcEntity*>(msg->getContextPointer());
+        entity->handleMessage(msg);
+        return;
+    }
+
     cPacket* pkt = check_and_cast<cPacket *>(msg);
     EV << NOW << " LteRlcAm : Received packet " << pkt->getName() << " from port "
        << pkt->getArrivalGate()->getName() << endl;
@@ -269,3 +376,16 @@ void LteRlcAm::handleMessage(cMessage* msg)
     }
     return;
 }
+
+void LteRlcAm::finish()
+{
+    if (!entityProfiling_)
+        return;
+
+    entityProfile_.record(this);
+    if (pooledEntities_)
+    {
+        recordScalar("rlcEntitiesAllocated", txBufferPool_.getAllocated() + rxBufferPool_.getAllocated());
+        recordScalar("rlcEntitiesReused", txBufferPool_.getReused() + rxBufferPool_.getReused());
+    }
+}
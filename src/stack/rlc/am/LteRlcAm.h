@@ -14,6 +14,7 @@
 #include "common/LteCommon.h"
 #include "common/LteControlInfo.h"
 #include "stack/rlc/am/packet/LteRlcAmPdu.h"
+#include "stack/rlc/LteRlcEntity.h"
 
 class AmTxQueue;
 class AmRxQueue;
@@ -26,8 +27,12 @@ class AmRxQueue;
  * It implements the acknowledged mode (AM):
  *
  * TODO
+ *
+ * TX/RX buffers run in their own submodules, unless the
+ * pooledEntities parameter is set: in that case they run in
+ * this module and are recycled through per-module pools.
  */
-class LteRlcAm : public omnetpp::cSimpleModule
+class LteRlcAm : public omnetpp::cSimpleModule, public LteRlcEntityOwner
 {
   protected:
 
@@ -49,13 +54,25 @@ class LteRlcAm : public omnetpp::cSimpleModule
     omnetpp::cGate* up_[2];
     omnetpp::cGate* down_[2];
 
+    // if true, buffers run in this module and are drawn from the pools below
+    bool pooledEntities_;
+    LteRlcEntityPool<AmTxQueue> txBufferPool_;
+    LteRlcEntityPool<AmRxQueue> rxBufferPool_;
+
+    // if true, the wall-clock cost of creating and deleting buffers is recorded
+    bool entityProfiling_;
+    LteRlcEntityProfile entityProfile_;
+
   public:
     LteRlcAm()
     {
+        pooledEntities_ = false;
+        entityProfiling_ = false;
     }
-    virtual ~LteRlcAm()
-    {
-    }
+    virtual ~LteRlcAm();
+
+    virtual void takeObj(omnetpp::cOwnedObject* obj) override { take(obj); }
+    virtual void dropObj(omnetpp::cOwnedObject* obj) override { drop(obj); }
 
   protected:
 
@@ -66,9 +83,17 @@ class LteRlcAm : public omnetpp::cSimpleModule
     virtual void handleMessage(omnetpp::cMessage *msg) override;
 
     virtual void initialize() override;
-    virtual void finish() override
-    {
-    }
+    virtual void finish() override;
+
+    /**
+     * createTxBuffer()/createRxBuffer() return a new, initialized buffer,
+     * either hosted by a new submodule or drawn from the pool.
+     * deleteTxBuffer()/deleteRxBuffer() dispose of a buffer accordingly
+     */
+    AmTxQueue* createTxBuffer(const char* name);
+    AmRxQueue* createRxBuffer(const char* name);
+    void deleteTxBuffer(AmTxQueue* txbuf);
+    void deleteRxBuffer(AmRxQueue* rxbuf);
 
     /**
      * deleteQueues() must be called on handover
@@ -13,44 +13,47 @@
 #include "common/LteControlInfo.h"
 #include "stack/mac/layer/LteMacBase.h"
 
-Define_Module(AmRxQueue);
-
 using namespace omnetpp;
 
 unsigned int AmRxQueue::totalCellRcvdBytes_ = 0;
 
-AmRxQueue::AmRxQueue() :
-    timer_(this)
+AmRxQueue::AmRxQueue(cSimpleModule* module) :
+    LteRlcEntity(module), timer_(module)
 {
-    rxWindowDesc_.firstSeqNum_ = 0;
-    rxWindowDesc_.seqNum_ = 0;
-    lastSentAck_ = 0;
-    firstSdu_ = 0;
-
     // in order create a back connection (AM CTRL) , a flow control
     // info for sending ctrl messages to tx entity is required
 
     flowControlInfo_ = NULL;
+    pendingSdu_ = NULL;
 
     timer_.setTimerId(BUFFERSTATUS_T);
+    timer_.setContextPointer(this);
+
+    take(&pduBuffer_);
 }
 
 void AmRxQueue::initialize()
 {
+    rxWindowDesc_.firstSeqNum_ = 0;
+    rxWindowDesc_.seqNum_ = 0;
+    lastSentAck_ = 0;
+    firstSdu_ = 0;
+
     //  loading parameters from NED
     rxWindowDesc_.windowSize_ = par("rxWindowSize");
     ackReportInterval_ = par("ackReportInterval");
     statusReportInterval_ = par("statusReportInterval");
 
-    discarded_.resize(rxWindowDesc_.windowSize_);
-    received_.resize(rxWindowDesc_.windowSize_);
+    rxRing_.init(rxWindowDesc_.windowSize_);
+    discarded_.assign(rxRing_.size(), false);
+    received_.assign(rxRing_.size(), false);
     totalRcvdBytes_ = 0;
 
-    lteRlc_ = check_and_cast<LteRlcAm *>(getParentModule()->getSubmodule("am"));
+    lteRlc_ = check_and_cast<LteRlcAm *>(module_->getParentModule()->getSubmodule("am"));
 
     //statistics
     LteMacBase* mac = check_and_cast<LteMacBase*>(
-        getParentModule()->getParentModule()->getSubmodule("mac"));
+        module_->getParentModule()->getParentModule()->getSubmodule("mac"));
 
     if (mac->getNodeType() == ENODEB)
     {
@@ -77,6 +80,19 @@ void AmRxQueue::initialize()
     }
 }
 
+void AmRxQueue::clear()
+{
+    pduBuffer_.clear();
+
+    if (timer_.busy())
+        timer_.stop();
+
+    delete flowControlInfo_;
+    flowControlInfo_ = NULL;
+    delete pendingSdu_;
+    pendingSdu_ = NULL;
+}
+
 void AmRxQueue::handleMessage(cMessage* msg)
 {
     if (!(msg->isSelfMessage()))
@@ -94,7 +110,7 @@ void AmRxQueue::handleMessage(cMessage* msg)
 
     for (unsigned int i = 0; i < rxWindowDesc_.windowSize_; i++)
     {
-        if (pduBuffer_.get(i) != 0)
+        if (pduBuffer_.get(rxRing_.slot(i)) != 0)
         {
             timer_.start(statusReportInterval_);
             break;
@@ -119,11 +135,11 @@ void AmRxQueue::discard(const int sn)
 
     for (int i = 0; i <= index; ++i)
     {
-        discarded_.at(i) = true;
+        discarded_.at(rxRing_.slot(i)) = true;
 
-        if (pduBuffer_.get(i) != NULL)
+        if (pduBuffer_.get(rxRing_.slot(i)) != NULL)
         {
-            LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.remove(i));
+            LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.remove(rxRing_.slot(i)));
             FlowControlInfo* ci = check_and_cast<FlowControlInfo*>(pdu->getControlInfo());
             dir = (Direction) ci->getDirection();
             dstId = ci->getDestId();
@@ -151,7 +167,7 @@ void AmRxQueue::discard(const int sn)
 
 void AmRxQueue::enque(LteRlcAmPdu* pdu)
 {
-    Enter_Method("enque()");
+    Enter_Entity_Method("enque()");
 
     take(pdu);
 
@@ -272,7 +288,7 @@ void AmRxQueue::enque(LteRlcAmPdu* pdu)
 
         // Check if the PDU has already been received
 
-        if (received_.at(index) == true)
+        if (received_.at(rxRing_.slot(index)) == true)
         {
             EV << NOW << " AmRxQueue::enque the received PDU has index " << index << " which points to an already busy location" << endl;
 
@@ -280,7 +296,7 @@ void AmRxQueue::enque(LteRlcAmPdu* pdu)
             // to the same data structure of the PDU
             // stored in the buffer
 
-            LteRlcAmPdu* bufferedpdu = check_and_cast<LteRlcAmPdu*>( pduBuffer_.get(index));
+            LteRlcAmPdu* bufferedpdu = check_and_cast<LteRlcAmPdu*>( pduBuffer_.get(rxRing_.slot(index)));
 
             if (bufferedpdu->getSnoMainPacket() == pdu->getSnoMainPacket())
             {
@@ -298,8 +314,8 @@ void AmRxQueue::enque(LteRlcAmPdu* pdu)
         else
         {
             // Buffer the PDU
-            pduBuffer_.addAt(index, pdu);
-            received_.at(index) = true;
+            pduBuffer_.addAt(rxRing_.slot(index), pdu);
+            received_.at(rxRing_.slot(index)) = true;
             // Check if this PDU forms a complete SDU
             checkCompleteSdu(index);
         }
@@ -308,32 +324,38 @@ void AmRxQueue::enque(LteRlcAmPdu* pdu)
 
 void AmRxQueue::passUp(const int index)
 {
-    Enter_Method("passUp");
+    Enter_Entity_Method("passUp");
 
-    LteRlcAm* lteRlc = check_and_cast<LteRlcAm *>(getParentModule()->getSubmodule("am"));
+    LteRlcAm* lteRlc = check_and_cast<LteRlcAm *>(module_->getParentModule()->getSubmodule("am"));
 
-    // duplicate buffered PDU. We cannot detach it from receiver window until a move Rx command is executed.
-    LteRlcAmPdu* bufferedpdu = (check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(index)))->dup();
+    LteRlcAmPdu* bufferedpdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(rxRing_.slot(index)));
 
     EV << NOW << " AmRxQueue::passUp passing up SDU[" << bufferedpdu->getSnoMainPacket() << "] referenced by PDU at position " << index << endl;
 
+    // the SDU is carried by its first PDU only. If that PDU has already been shifted out
+    // of the receiver window by a MRW command, the SDU has been kept by moveRxWindow()
+    cPacket* carriedSdu = bufferedpdu->getEncapsulatedPacket();
+    if (carriedSdu == NULL && index == 0 && firstSdu_ == (int)bufferedpdu->getSnoMainPacket())
+        carriedSdu = pendingSdu_;
+    if (carriedSdu == NULL)
+        throw cRuntimeError("AmRxQueue::passUp(): the PDU at position %d does not carry SDU %d", index, bufferedpdu->getSnoMainPacket());
+
+    // duplicate the SDU. We cannot detach it from receiver window until a move Rx command is executed.
+    LteRlcAmSdu* sdu = check_and_cast<LteRlcAmSdu*>(carriedSdu)->dup();
+
     // duplicate buffered PDU control info too.
-    FlowControlInfo * ci = check_and_cast<FlowControlInfo*>(
-        (check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(index)))->getControlInfo()->dup());
+    FlowControlInfo * ci = check_and_cast<FlowControlInfo*>(bufferedpdu->getControlInfo()->dup());
 
-    int origPktSize = bufferedpdu->getEncapsulatedPacket()->getEncapsulatedPacket()->getByteLength();
+    int origPktSize = sdu->getEncapsulatedPacket()->getByteLength();
 
     EV << NOW << " AmRxQueue::passUp original packet size  " << origPktSize << " pdu size " << bufferedpdu->getByteLength() << endl;
 
-    bufferedpdu->setByteLength(origPktSize); // Set original packet size before decapsulating
-    bufferedpdu->getEncapsulatedPacket()->setByteLength(origPktSize);
+    sdu->setByteLength(origPktSize); // Set original packet size before decapsulating
 
-    cPacket* sdu = bufferedpdu->decapsulate();
     cPacket* pkt = sdu->decapsulate();
 
-    // cleanup duped PDU.
+    // cleanup duped SDU.
     delete sdu;
-    delete bufferedpdu;
 
     Direction dir = (Direction) ci->getDirection();
     MacNodeId dstId = ci->getDestId();
@@ -372,7 +394,7 @@ void AmRxQueue::passUp(const int index)
 
 void AmRxQueue::checkCompleteSdu(const int index)
 {
-    LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(index));
+    LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(rxRing_.slot(index)));
     int incomingSdu = pdu->getSnoMainPacket();
 
     EV << NOW << " AmRxQueue::checkCompleteSdu at position " << index << " for SDU number " << incomingSdu << endl;
@@ -419,7 +441,7 @@ void AmRxQueue::checkCompleteSdu(const int index)
                 // check for previous PDUs
                 for (int i = index - 1; i >= 0; i--)
                 {
-                    if (received_.at(i) == false)
+                    if (received_.at(rxRing_.slot(i)) == false)
                     {
                         // There is NO RLC PDU in this position
                         // The SDU is not complete
@@ -428,7 +450,7 @@ void AmRxQueue::checkCompleteSdu(const int index)
                     }
                     else
                     {
-                        tempPdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(i));
+                        tempPdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(rxRing_.slot(i)));
                         tempSdu = tempPdu->getSnoMainPacket();
 
                         if (tempSdu != incomingSdu)
@@ -445,8 +467,8 @@ void AmRxQueue::checkCompleteSdu(const int index)
                             || tempPdu->isWhole())
                         {
                             throw cRuntimeError("AmRxQueue::checkCompleteSdu(): backward search: sequence error, found last or whole PDU [%d] preceding a middle one [%d], belonging to  SDU [%d], current SDU is [%d]",tempPdu->getSnoFragment(),(check_and_cast<LteRlcAmPdu*>(
-                                        pduBuffer_.get(i+1)))->getSnoFragment(),(check_and_cast<LteRlcAmPdu*>(
-                                        pduBuffer_.get(i+1)))->getSnoMainPacket(),tempSdu);
+                                        pduBuffer_.get(rxRing_.slot(i+1))))->getSnoFragment(),(check_and_cast<LteRlcAmPdu*>(
+                                        pduBuffer_.get(rxRing_.slot(i+1))))->getSnoMainPacket(),tempSdu);
                         }
                     }
                 }
@@ -480,7 +502,7 @@ void AmRxQueue::checkCompleteSdu(const int index)
 
     for (int i = index + 1; i < (rxWindowDesc_.windowSize_); ++i)
     {
-        if (received_.at(i) == false)
+        if (received_.at(rxRing_.slot(i)) == false)
         {
             EV << NOW << " AmRxQueue::checkCompleteSdu forward search failed, no PDU at position " << i << " corresponding to"
             " SN  " << i+rxWindowDesc_.firstSeqNum_ << endl;
@@ -491,7 +513,7 @@ void AmRxQueue::checkCompleteSdu(const int index)
         }
         else
         {
-            tempPdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(i));
+            tempPdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(rxRing_.slot(i)));
             tempSdu = tempPdu->getSnoMainPacket();
             if (tempSdu != incomingSdu)
             throw cRuntimeError("AmRxQueue::checkCompleteSdu(): SDU numbers differ from position %d to %d : former SDU %d second %d",i,i-1,incomingSdu,tempSdu);
@@ -523,7 +545,7 @@ void AmRxQueue::checkCompleteSdu(const int index)
 
 void AmRxQueue::sendStatusReport()
 {
-    Enter_Method("sendStatusReport()");
+    Enter_Entity_Method("sendStatusReport()");
     EV << NOW << " AmRxQueue::sendStatusReport " << endl;
 
     // Check if the prohibit status report has been set.
@@ -539,19 +561,19 @@ void AmRxQueue::sendStatusReport()
 
     // Compute cumulative ACK
     int cumulative = 0;
-    bool hole = !received_.at(0);
+    bool hole = !received_.at(rxRing_.slot(0));
     std::vector<bool> bitmap;
 
     for (int i = 0; i < rxWindowDesc_.windowSize_; ++i)
     {
-        if ((received_.at(i) == true) && !hole)
+        if ((received_.at(rxRing_.slot(i)) == true) && !hole)
         {
             cumulative++;
         }
         else if ((cumulative > 0) || hole)
         {
             hole = true;
-            bitmap.push_back(received_.at(i));
+            bitmap.push_back(received_.at(rxRing_.slot(i)));
         }
     }
 
@@ -609,7 +631,7 @@ int AmRxQueue::computeWindowShift() const
     int shift = 0;
     for ( int i = 0; i < rxWindowDesc_.windowSize_; ++i)
     {
-        if (received_.at(i) == true || discarded_.at(i) == true)
+        if (received_.at(rxRing_.slot(i)) == true || discarded_.at(rxRing_.slot(i)) == true)
         {
             ++shift;
         }
@@ -643,42 +665,42 @@ void AmRxQueue::moveRxWindow(const int seqNum)
 
     for ( int i = 0; i < pos; ++i)
     {
-        if (pduBuffer_.get(i) != NULL)
+        unsigned int slot = rxRing_.slot(i);
+        if (pduBuffer_.get(slot) != NULL)
         {
-            pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.remove(i));
+            pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.remove(slot));
             currentSdu = (pdu->getSnoMainPacket());
 
             if (pdu->isLast() || pdu->isWhole())
             {
                 // Reset the last PDU seen.
                 currentSdu = -1;
+                delete pendingSdu_;
+                pendingSdu_ = NULL;
+            }
+            else if (pdu->isFirst())
+            {
+                // the SDU is carried by this PDU only: keep it until its last PDU
+                // is passed up or shifted out as well
+                delete pendingSdu_;
+                pdu->setByteLength(pdu->getEncapsulatedPacket()->getByteLength()); // Set SDU size before decapsulating
+                pendingSdu_ = check_and_cast<LteRlcAmSdu*>(pdu->decapsulate());
             }
-            received_.at(i) = false;
-            discarded_.at(i) = false;
             drop(pdu);
             delete pdu;
         }
         else
         {
             currentSdu = -1;
+            delete pendingSdu_;
+            pendingSdu_ = NULL;
         }
+        // the slot is reused for the positions entering the window
+        received_.at(slot) = false;
+        discarded_.at(slot) = false;
     }
 
-    for ( int i = pos; i < rxWindowDesc_.windowSize_; ++i)
-    {
-        if (pduBuffer_.get(i) != NULL)
-        {
-            pduBuffer_.addAt(i-pos, pduBuffer_.remove(i));
-        }
-        else
-        {
-            pduBuffer_.remove(i);
-        }
-        received_.at(i-pos) = received_.at(i);
-        discarded_.at(i-pos) = discarded_.at(i);
-        received_.at(i) = false;
-        discarded_.at(i) = false;
-    }
+    rxRing_.advance(pos);
 
     rxWindowDesc_.firstSeqNum_ += pos;
 
@@ -692,5 +714,6 @@ void AmRxQueue::moveRxWindow(const int seqNum)
 
 AmRxQueue::~AmRxQueue()
 {
+    delete pendingSdu_;
 }
 
@@ -16,8 +16,9 @@
 #include "stack/rlc/am/packet/LteRlcAmSdu_m.h"
 #include "stack/pdcp_rrc/packet/LtePdcpPdu_m.h"
 #include "stack/rlc/am/LteRlcAm.h"
+#include "stack/rlc/LteRlcEntity.h"
 
-class AmRxQueue : public omnetpp::cSimpleModule
+class AmRxQueue : public LteRlcEntity
 {
   protected:
 
@@ -39,6 +40,10 @@ class AmRxQueue : public omnetpp::cSimpleModule
     //! SDU reconstructed at the beginning of the Receiver buffer
     int firstSdu_;
 
+    //! SDU carried by the first PDU of firstSdu_, kept when that PDU is shifted
+    //! out of the window while the other PDUs of the SDU are still buffered
+    LteRlcAmSdu* pendingSdu_;
+
     //! Timer to manage the buffer status report
     TTimer timer_;
 
@@ -55,6 +60,9 @@ class AmRxQueue : public omnetpp::cSimpleModule
      */
     std::vector<bool> discarded_;
 
+    //! Ring indexing of pduBuffer_, received_ and discarded_ by window position
+    RlcWindowRing rxRing_;
+
     /*
      * FlowControlInfo matrix : used for CTRL messages generation
      */
@@ -74,7 +82,7 @@ class AmRxQueue : public omnetpp::cSimpleModule
 
   public:
 
-    AmRxQueue();
+    AmRxQueue(omnetpp::cSimpleModule* module);
 
     virtual ~AmRxQueue();
 
@@ -87,6 +95,9 @@ class AmRxQueue : public omnetpp::cSimpleModule
     //initialize
     void initialize() override;
 
+    //! Delete the buffered PDUs and stop the status report timer
+    virtual void clear() override;
+
   protected:
 
     //! Send the RLC SDU stored in the buffer to the upper layer
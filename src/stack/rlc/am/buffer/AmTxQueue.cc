@@ -10,20 +10,26 @@
 #include "stack/rlc/am/buffer/AmTxQueue.h"
 #include "stack/mac/layer/LteMacBase.h"
 
-Define_Module(AmTxQueue);
-
 using namespace omnetpp;
 
-AmTxQueue::AmTxQueue() :
-    pduTimer_(this), mrwTimer_(this), bufferStatusTimer_(this)
+AmTxQueue::AmTxQueue(cSimpleModule* module) :
+    LteRlcEntity(module), pduTimer_(module), mrwTimer_(module), bufferStatusTimer_(module)
 {
-    currentSdu_ = NULL;
+    currentSduSno_ = 0;
 
     lteInfo_ = NULL;
     //initialize timer IDs
     pduTimer_.setTimerId(PDU_T);
     mrwTimer_.setTimerId(MRW_T);
     bufferStatusTimer_.setTimerId(BUFFER_T);
+    pduTimer_.setContextPointer(this);
+    mrwTimer_.setContextPointer(this);
+    bufferStatusTimer_.setContextPointer(this);
+
+    take(&sduQueue_);
+    take(&pduRtxQueue_);
+    take(&pduBuffer_);
+    take(&mrwRtxQueue_);
 }
 
 void AmTxQueue::initialize()
@@ -34,13 +40,33 @@ void AmTxQueue::initialize()
     pduRtxTimeout_ = par("pduRtxTimeout");
     ctrlPduRtxTimeout_ = par("ctrlPduRtxTimeout");
     bufferStatusTimeout_ = par("bufferStatusTimeout");
+    txWindowDesc_ = RlcWindowDesc();
     txWindowDesc_.windowSize_ = par("txWindowSize");
+    mrwDesc_ = MrwDesc();
+    fragDesc_.resetFragmentation();
     // resize status vectors
-    received_.resize(txWindowDesc_.windowSize_, false);
-    discarded_.resize(txWindowDesc_.windowSize_, false);
+    txRing_.init(txWindowDesc_.windowSize_);
+    received_.assign(txRing_.size(), false);
+    discarded_.assign(txRing_.size(), false);
 
     // reference to corresponding RLC AM module
-    lteRlc_ = check_and_cast<LteRlcAm *>(getParentModule()->getSubmodule("am"));
+    lteRlc_ = check_and_cast<LteRlcAm *>(module_->getParentModule()->getSubmodule("am"));
+}
+
+void AmTxQueue::clear()
+{
+    sduQueue_.clear();
+    pduRtxQueue_.clear();
+    pduBuffer_.clear();
+    mrwRtxQueue_.clear();
+
+    delete lteInfo_;
+    lteInfo_ = NULL;
+
+    pduTimer_.clear();
+    mrwTimer_.clear();
+    if (bufferStatusTimer_.busy())
+        bufferStatusTimer_.stop();
 }
 
 AmTxQueue::~AmTxQueue()
@@ -59,7 +85,7 @@ void AmTxQueue::enque(LteRlcAmSdu* sdu)
 
 void AmTxQueue::addPdus()
 {
-    Enter_Method("addPdus()");
+    Enter_Entity_Method("addPdus()");
 
     // Add PDUs to the AM transmission buffer until the transmission
     // window is full or until the SDU buffer is empty
@@ -67,7 +93,7 @@ void AmTxQueue::addPdus()
 
     while ((txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_) < txWindowDesc_.windowSize_)
     {
-        if (currentSdu_ == NULL && sduQueue_.isEmpty())
+        if (fragDesc_.totalFragments_ == 0 && sduQueue_.isEmpty())
         {
             // No data to send
 
@@ -75,18 +101,23 @@ void AmTxQueue::addPdus()
             break;
         }
 
+        // SDU to be carried by the new PDU: only the first fragment carries the SDU,
+        // since the receiver reads it from the first PDU of the SDU
+        LteRlcAmSdu* currentSdu = NULL;
+
         // Check if we can start to fragment a new SDU
-        if (currentSdu_ == NULL)
+        if (fragDesc_.totalFragments_ == 0)
         {
             EV << NOW << " AmTxQueue::addPdus - No pending SDU has been found" << endl;
             // Get the first available SDU (buffer has already been check'd being non empty)
-            currentSdu_ = check_and_cast<LteRlcAmSdu*>(sduQueue_.pop());
+            currentSdu = check_and_cast<LteRlcAmSdu*>(sduQueue_.pop());
+            currentSduSno_ = currentSdu->getSnoMainPacket();
 
             // Starting Fragmentation
-            fragDesc_.startFragmentation(currentSdu_->getByteLength(), txWindowDesc_.seqNum_);
+            fragDesc_.startFragmentation(currentSdu->getByteLength(), txWindowDesc_.seqNum_);
 
             EV << NOW << " AmTxQueue::addPdus current SDU size "
-               << currentSdu_->getByteLength() << " will be fragmented in "
+               << currentSdu->getByteLength() << " will be fragmented in "
                << fragDesc_.totalFragments_ << " PDUs, each  of size "
                << fragDesc_.fragUnit_ << endl;
 
@@ -94,10 +125,8 @@ void AmTxQueue::addPdus()
             delete lteInfo_;
 
             lteInfo_ = check_and_cast<FlowControlInfo*>(
-                currentSdu_->getControlInfo()->dup());
+                currentSdu->getControlInfo()->dup());
         }
-        // Create a copy of the SDU
-        LteRlcAmSdu* sduCopy = currentSdu_->dup();
         // duplicate SDU control info
         FlowControlInfo* lteInfo = lteInfo_->dup();
 
@@ -110,9 +139,10 @@ void AmTxQueue::addPdus()
         pdu->setSnoFragment(txWindowDesc_.seqNum_);
         pdu->setFirstSn(fragDesc_.firstSn_);
         pdu->setLastSn(fragDesc_.firstSn_ + fragDesc_.totalFragments_ - 1);
-        pdu->setSnoMainPacket(sduCopy->getSnoMainPacket());
+        pdu->setSnoMainPacket(currentSduSno_);
         // encapsulate main SDU
-        pdu->encapsulate(sduCopy);
+        if (currentSdu != NULL)
+            pdu->encapsulate(currentSdu);
         // set fragment size
         pdu->setByteLength(fragDesc_.fragUnit_);
         // set control info
@@ -122,16 +152,16 @@ void AmTxQueue::addPdus()
         // try the insertion into tx buffer
         int txWindowIndex = txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_;
 
-        if (pduRtxQueue_.get(txWindowIndex) == NULL)
+        if (pduRtxQueue_.get(txRing_.slot(txWindowIndex)) == NULL)
         {
             // store a copy of current PDU
             LteRlcAmPdu * pduCopy = pdu->dup();
             pduCopy->setControlInfo(lteInfo->dup());
-            pduRtxQueue_.addAt(txWindowIndex, pduCopy);
+            pduRtxQueue_.addAt(txRing_.slot(txWindowIndex), pduCopy);
 
-            if (received_.at(txWindowIndex) || discarded_.at(txWindowIndex))
+            if (received_.at(txRing_.slot(txWindowIndex)) || discarded_.at(txRing_.slot(txWindowIndex)))
             throw cRuntimeError("AmTxQueue::addPdus(): trying to add a PDU to a  position marked received [%d] discarded [%d]",
-                (int)(received_.at(txWindowIndex)) ,(int)(discarded_.at(txWindowIndex)));
+                (int)(received_.at(txRing_.slot(txWindowIndex))) ,(int)(discarded_.at(txRing_.slot(txWindowIndex))));
         }
         else
         {
@@ -144,9 +174,6 @@ void AmTxQueue::addPdus()
         if (fragDesc_.addFragment())
         {
             fragDesc_.resetFragmentation();
-            drop(currentSdu_);
-            delete currentSdu_;
-            currentSdu_ = NULL;
         }
         // Update Sequence Number
         txWindowDesc_.seqNum_++;
@@ -185,7 +212,7 @@ void AmTxQueue::bufferControlPdu(LteRlcAmPdu *pkt){
 
 void AmTxQueue::bufferFragmented(LteRlcAmPdu *pkt, bool isControl, bool isRetransmission)
 {
-    Enter_Method("bufferFragmented()"); // Direct Method Call
+    Enter_Entity_Method("bufferFragmented()"); // Direct Method Call
     take(pkt); // Take ownership
 
     EV << NOW << " AmTxQueue : Enqueuing " << pkt->getName() << " of size "
@@ -221,7 +248,7 @@ void AmTxQueue::discard(const int seqNum)
             seqNum, txWindowDesc_.firstSeqNum_);
     }
 
-    if (discarded_.at(txWindowIndex) == true)
+    if (discarded_.at(txRing_.slot(txWindowIndex)) == true)
     {
         EV << " AmTxQueue::discard requested to discard an already discarded  PDU :"
         " sequence number" << seqNum << " , window first sequence is " << txWindowDesc_.firstSeqNum_ << endl;
@@ -229,11 +256,11 @@ void AmTxQueue::discard(const int seqNum)
     else
     {
         // mark current PDU for discard
-        discarded_.at(txWindowIndex) = true;
+        discarded_.at(txRing_.slot(txWindowIndex)) = true;
     }
 
     LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(
-        pduRtxQueue_.get(txWindowIndex));
+        pduRtxQueue_.get(txRing_.slot(txWindowIndex)));
 
     if (pduTimer_.busy(seqNum))
         pduTimer_.remove(seqNum);
@@ -243,15 +270,15 @@ void AmTxQueue::discard(const int seqNum)
     for (int i = (txWindowIndex + 1);
         i < (txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_); ++i)
     {
-        if (pduRtxQueue_.get(i) != NULL)
+        if (pduRtxQueue_.get(txRing_.slot(i)) != NULL)
         {
-            nextPdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(i));
+            nextPdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(txRing_.slot(i)));
             if (pdu->getSnoMainPacket() == nextPdu->getSnoMainPacket())
             {
                 // Mark the PDU to be discarded
-                if (!discarded_.at(i))
+                if (!discarded_.at(txRing_.slot(i)))
                 {
-                    discarded_.at(i) = true;
+                    discarded_.at(txRing_.slot(i)) = true;
                     // Stop the timer
                     if (pduTimer_.busy(i + txWindowDesc_.firstSeqNum_))
                         pduTimer_.remove(i + txWindowDesc_.firstSeqNum_);
@@ -270,17 +297,17 @@ void AmTxQueue::discard(const int seqNum)
     // Check backward in the buffer if there are other PDUs related to the same SDU
     for (int i = txWindowIndex - 1; i >= 0; i--)
     {
-        if (pduRtxQueue_.get(i) == NULL)
+        if (pduRtxQueue_.get(txRing_.slot(i)) == NULL)
             throw cRuntimeError("AmTxBuffer::discard(): trying to get access to missing PDU %d", i);
 
-        nextPdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(i));
+        nextPdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(txRing_.slot(i)));
 
         if (pdu->getSnoMainPacket() == nextPdu->getSnoMainPacket())
         {
-            if (!discarded_.at(i))
+            if (!discarded_.at(txRing_.slot(i)))
             {
                 // Mark the PDU to be discarded
-                discarded_.at(i) = true;
+                discarded_.at(txRing_.slot(i)) = true;
             }
             // Stop the timer
             if (pduTimer_.busy(i + txWindowDesc_.firstSeqNum_))
@@ -306,7 +333,7 @@ void AmTxQueue::checkForMrw()
 
     for (int i = 0; i < (txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_); ++i)
     {
-        if ((discarded_.at(i) == true) || (received_.at(i) == true))
+        if ((discarded_.at(txRing_.slot(i)) == true) || (received_.at(txRing_.slot(i)) == true))
         {
             lastPdu = i;
             toMove = true;
@@ -345,13 +372,14 @@ void AmTxQueue::moveTxWindow(const int seqNum)
 
     for (int i = 0; i < pos; ++i)
     {
-        if (pduRtxQueue_.get(i) != NULL)
+        unsigned int slot = txRing_.slot(i);
+        if (pduRtxQueue_.get(slot) != NULL)
         {
             EV << NOW << " AmTxQueue::moveTxWindow deleting PDU ["
                << i + txWindowDesc_.firstSeqNum_
                << "] corresponding index " << i << endl;
 
-            pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(i));
+            pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(slot));
             delete pdu;
             // Stop the rtx timer event
             if (pduTimer_.busy(i + txWindowDesc_.firstSeqNum_))
@@ -361,73 +389,21 @@ void AmTxQueue::moveTxWindow(const int seqNum)
                    << i + txWindowDesc_.firstSeqNum_
                    << "] corresponding index " << i << endl;
             }
-            received_.at(i)=false;
-            discarded_.at(i)=false;
+            // the slot is reused for the positions entering the window
+            received_.at(slot)=false;
+            discarded_.at(slot)=false;
         }
         else
         throw cRuntimeError("AmTxQueue::moveTxWindow(): encountered empty PDU at location %d, shift position %d", i, pos);
     }
 
-    for (int i = pos;
-        i < ((txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_)); ++i)
-    {
-        if (pduRtxQueue_.get(i) != NULL)
-        {
-            pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(i));
-            pduRtxQueue_.addAt(i - pos, pdu);
-
-            EV << NOW << " AmTxQueue::moveTxWindow  PDU ["
-               << i + txWindowDesc_.firstSeqNum_
-               << "] corresponding index " << i
-               << " being moved at position " << i - pos << endl;
-        }
-        else
-        {
-            throw cRuntimeError("AmTxQueue::moveTxWindow(): encountered empty PDU at location %d, shift position %d", i, pos);
-        }
-
-        EV << NOW << " AmTxQueue::moveTxWindow  PDU ["
-           << i + txWindowDesc_.firstSeqNum_
-           << "] corresponding new index " << i - pos
-           << " marked as received [" << (received_.at(i - pos))
-           << "] , discarded [" << (discarded_.at(i - pos)) << "]" << endl;
-
-        received_.at(i - pos) = received_.at(i);
-        discarded_.at(i - pos) = discarded_.at(i);
-
-        received_.at(i) = false;
-        discarded_.at(i) = false;
-
-        EV << NOW << " AmTxQueue::moveTxWindow  location [" << i
-           << "] corresponding new PDU "
-           << i + pos + txWindowDesc_.firstSeqNum_
-           << " marked as received [" << (received_.at(i))
-           << "] , discarded [" << (discarded_.at(i)) << "]" << endl;
-    }
-
-            // cleanup
-    for (int i = (txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_);
-        i < txWindowDesc_.windowSize_; ++i)
-    {
-        if (pduRtxQueue_.get(i) != NULL)
-            throw cRuntimeError("AmTxQueue::moveTxWindow(): encountered busy PDU at location %d, shift position %d", i,
-                pos);
-
-        EV << NOW << " AmTxQueue::moveTxWindow  empty location [" << i
-           << "] marked as received [" << (received_.at(i))
-           << "] , discarded [" << (discarded_.at(i)) << "]" << endl;
-
-        received_.at(i) = false;
-        discarded_.at(i) = false;
-    }
-
+    // the PDUs still in the window keep their slots
+    txRing_.advance(pos);
     txWindowDesc_.firstSeqNum_ += pos;
 
     EV << NOW << " AmTxQueue::moveTxWindow completed. First sequence number "
        << txWindowDesc_.firstSeqNum_ << " current sequence number "
-       << txWindowDesc_.seqNum_ << " cleaned up locations from "
-       << txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_ << " to "
-       << txWindowDesc_.windowSize_ - 1 << endl;
+       << txWindowDesc_.seqNum_ << endl;
 
     // Try to add more PDUs to the buffer
     addPdus();
@@ -473,7 +449,7 @@ void AmTxQueue::sendMrw(const int seqNum)
 
 void AmTxQueue::handleControlPacket(cPacket* pkt)
 {
-    Enter_Method("handleControlPacket()");
+    Enter_Entity_Method("handleControlPacket()");
     LteRlcAmPdu * pdu = check_and_cast<LteRlcAmPdu*>(pkt);
     // get RLC type descriptor
     short type = pdu->getAmType();
@@ -516,7 +492,7 @@ void AmTxQueue::handleControlPacket(cPacket* pkt)
             break;
         }
 
-        ASSERT(pdu->getOwner() == this);
+        ASSERT(pdu->getOwner() == module_);
         delete pdu;
     }
 
@@ -541,7 +517,7 @@ void AmTxQueue::recvAck(const int seqNum)
     if (index >= txWindowDesc_.windowSize_)
         throw cRuntimeError("AmTxBuffer::recvAck(): ACK greater than window size %d", txWindowDesc_.windowSize_);
 
-    if (!(received_.at(index)))
+    if (!(received_.at(txRing_.slot(index))))
     {
         EV << NOW << " AmTxBuffer::recvAck canceling timer for PDU "
            << (index + txWindowDesc_.firstSeqNum_) << " index " << index << endl;
@@ -549,7 +525,7 @@ void AmTxQueue::recvAck(const int seqNum)
         if (pduTimer_.busy(index + txWindowDesc_.firstSeqNum_))
         pduTimer_.remove(index + txWindowDesc_.firstSeqNum_);
         // Received status variable is set at true after the
-        received_.at(index) = true;
+        received_.at(txRing_.slot(index)) = true;
     }
 }
 
@@ -581,7 +557,7 @@ void AmTxQueue::recvCumulativeAck(const int seqNum)
             "index [" << i << "] " << endl;
 
             // the ACK could have already been received
-            if (!(received_.at(i)))
+            if (!(received_.at(txRing_.slot(i))))
             {
                 // canceling timer for PDU
                 EV << NOW
@@ -591,7 +567,7 @@ void AmTxQueue::recvCumulativeAck(const int seqNum)
                 if (pduTimer_.busy(i + txWindowDesc_.firstSeqNum_))
                 pduTimer_.remove(i + txWindowDesc_.firstSeqNum_);
                 // Received status variable is set at true after the
-                received_.at(i) = true;
+                received_.at(txRing_.slot(i)) = true;
             }
         }
         checkForMrw();
@@ -623,7 +599,7 @@ void AmTxQueue::recvMrwAck(const int seqNum)
 
 void AmTxQueue::pduTimerHandle(const int sn)
 {
-    Enter_Method("pduTimerHandle");
+    Enter_Entity_Method("pduTimerHandle");
     // A timer is elapsed for the RLC PDU.
     // This function checks if the PDU has been correctly received.
     // If not, the handle checks if another transmission is possible, and
@@ -643,16 +619,16 @@ void AmTxQueue::pduTimerHandle(const int sn)
             "AmTxQueue::pduTimerHandle(): The PDU [%d] for which timer elapsed is out of the window : index [%d]", sn,
             index);
 
-    if (pduRtxQueue_.get(index) == NULL)
+    if (pduRtxQueue_.get(txRing_.slot(index)) == NULL)
         throw cRuntimeError("AmTxQueue::pduTimerHandle(): PDU %d not found", index);
 
     // Check if the PDU has been correctly received, if so the
     // timer should have been previously stopped.
-    if (received_.at(index) == true)
+    if (received_.at(txRing_.slot(index)) == true)
         throw cRuntimeError(" AmTxQueue::pduTimerHandle(): The PDU %d [index %d] has been already received", sn, index);
 
     // Get the PDU information
-    LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(index));
+    LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(txRing_.slot(index)));
 
     int nextTxNumber = pdu->getTxNumber() + 1;
 
@@ -668,7 +644,7 @@ void AmTxQueue::pduTimerHandle(const int sn)
     {
         EV << NOW << " AmTxQueue::pduTimerHandle starting new transmission" << endl;
         // extract PDU from buffer
-        pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(index));
+        pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(txRing_.slot(index)));
         // A new transmission can be started
         pdu->setTxNumber(nextTxNumber);
         // The RLC PDU is added to the retransmission buffer
@@ -676,7 +652,7 @@ void AmTxQueue::pduTimerHandle(const int sn)
         // .. with control info also!
         copy->setControlInfo(pdu->getControlInfo()->dup());
 
-        pduRtxQueue_.add(copy);
+        pduRtxQueue_.addAt(txRing_.slot(index), copy);
         // Reschedule the timer
         pduTimer_.add(pduRtxTimeout_, sn);
         // send down the PDU
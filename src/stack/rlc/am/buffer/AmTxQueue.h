@@ -18,6 +18,7 @@
 #include "stack/pdcp_rrc/packet/LtePdcpPdu_m.h"
 #include "common/LteControlInfo.h"
 #include "stack/rlc/am/LteRlcAm.h"
+#include "stack/rlc/LteRlcEntity.h"
 
 /*
  * RLC AM Mode Transmission Entity
@@ -30,7 +31,7 @@
  * moving transmission window enabled with ARQ and drop-timer mechanisms.
  */
 
-class AmTxQueue : public omnetpp::cSimpleModule
+class AmTxQueue : public LteRlcEntity
 {
   protected:
 
@@ -40,9 +41,9 @@ class AmTxQueue : public omnetpp::cSimpleModule
     LteRlcAm* lteRlc_;
 
     /*
-     * SDU (upper layer PDU) currently being processed
+     * Sequence number of the SDU (upper layer PDU) currently being fragmented
      */
-    LteRlcAmSdu * currentSdu_;
+    unsigned int currentSduSno_;
 
     /*
      * SDU Fragmentation descriptor
@@ -87,6 +88,9 @@ class AmTxQueue : public omnetpp::cSimpleModule
     // Discarded status variable
     std::vector<bool> discarded_;
 
+    // Ring indexing of pduRtxQueue_, received_ and discarded_ by window position
+    RlcWindowRing txRing_;
+
     // Transmission window descriptor
     RlcWindowDesc txWindowDesc_;
 
@@ -123,9 +127,24 @@ class AmTxQueue : public omnetpp::cSimpleModule
     std::map<int, LteRlcAmPdu *> unackedMrw_;
 
   public:
-    AmTxQueue();
+    AmTxQueue(omnetpp::cSimpleModule* module);
     virtual ~AmTxQueue();
 
+    /**
+     * Initialize
+     */
+    virtual void initialize() override;
+    /*
+     * Analyze gate of incoming packet and call proper handler
+     * @param msg
+     */
+    virtual void handleMessage(omnetpp::cMessage* msg) override;
+
+    /*
+     * Deletes the buffered SDUs and PDUs and stops the timers
+     */
+    virtual void clear() override;
+
     /*
      * Enqueues an upper layer packet into the transmission buffer
      * @param sdu the packet to be enqueued
@@ -158,16 +177,6 @@ class AmTxQueue : public omnetpp::cSimpleModule
 
   protected:
 
-    /**
-     * Initialize
-     */
-    virtual void initialize() override;
-    /*
-     * Analyze gate of incoming packet and call proper handler
-     * @param msg
-     */
-    virtual void handleMessage(omnetpp::cMessage* msg) override;
-
     /* Discards a given RLC PDU and all the PDUs related to the same SDU
      *
      * @param seqNum the sequence number of the PDU that triggers discarding
@@ -0,0 +1,126 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef LTERLCSDUSEGMENT_H_
+#define LTERLCSDUSEGMENT_H_
+
+#include "stack/rlc/packet/LteRlcSdu.h"
+
+/**
+ * @class LteRlcSduSegment
+ * @brief Segment of a RLC UM SDU
+ *
+ * Describes the bytes [offset, offset + length) of a SDU that has been
+ * split over several RLC PDUs, the length being the byte length of the
+ * segment. Segments do not copy the SDU: the SDU itself is carried by
+ * the segment that completes it, so that the receiver can deliver it
+ * once all the previous segments have been received.
+ */
+class LteRlcSduSegment : public omnetpp::cPacket
+{
+  protected:
+    // sequence number and length of the segmented SDU
+    unsigned int snoMainPacket_;
+    unsigned int lengthMainPacket_;
+
+    // position of the segment within the SDU
+    unsigned int offset_;
+
+    // the segmented SDU (only for the last segment)
+    LteRlcSdu* sdu_;
+
+  private:
+    void copy(const LteRlcSduSegment& other)
+    {
+        snoMainPacket_ = other.snoMainPacket_;
+        lengthMainPacket_ = other.lengthMainPacket_;
+        offset_ = other.offset_;
+        sdu_ = NULL;
+        if (other.sdu_ != NULL)
+        {
+            sdu_ = other.sdu_->dup();
+            take(sdu_);
+        }
+    }
+
+  public:
+    LteRlcSduSegment(const char* name = "rlcSduSegment", int kind = 0) :
+        omnetpp::cPacket(name, kind)
+    {
+        snoMainPacket_ = 0;
+        lengthMainPacket_ = 0;
+        offset_ = 0;
+        sdu_ = NULL;
+    }
+
+    /**
+     * Creates the segment of the given SDU starting at the given offset.
+     * The SDU is not copied, nor referenced: see setSdu()
+     */
+    LteRlcSduSegment(LteRlcSdu* sdu, unsigned int offset, unsigned int length) :
+        omnetpp::cPacket("rlcSduSegment")
+    {
+        snoMainPacket_ = sdu->getSnoMainPacket();
+        lengthMainPacket_ = sdu->getByteLength();
+        offset_ = offset;
+        sdu_ = NULL;
+        setByteLength(length);
+    }
+
+    LteRlcSduSegment(const LteRlcSduSegment& other) : omnetpp::cPacket(other) { copy(other); }
+
+    LteRlcSduSegment& operator=(const LteRlcSduSegment& other)
+    {
+        if (this == &other)
+            return *this;
+        if (sdu_ != NULL)
+            dropAndDelete(sdu_);
+        omnetpp::cPacket::operator=(other);
+        copy(other);
+        return *this;
+    }
+
+    virtual ~LteRlcSduSegment()
+    {
+        if (sdu_ != NULL)
+            dropAndDelete(sdu_);
+    }
+
+    virtual LteRlcSduSegment* dup() const override { return new LteRlcSduSegment(*this); }
+
+    unsigned int getSnoMainPacket() const { return snoMainPacket_; }
+    unsigned int getLengthMainPacket() const { return lengthMainPacket_; }
+    unsigned int getOffset() const { return offset_; }
+
+    // true if this is the segment completing the SDU
+    bool isLast() const { return offset_ + getByteLength() >= lengthMainPacket_; }
+
+    /**
+     * Attaches the SDU to its last segment, taking its ownership
+     */
+    void setSdu(LteRlcSdu* sdu)
+    {
+        take(sdu);
+        sdu_ = sdu;
+    }
+
+    /**
+     * Detaches the SDU from the segment (NULL if this is not the last segment)
+     */
+    LteRlcSdu* removeSdu()
+    {
+        LteRlcSdu* sdu = sdu_;
+        if (sdu != NULL)
+            drop(sdu);
+        sdu_ = NULL;
+        return sdu;
+    }
+};
+
+#endif /* LTERLCSDUSEGMENT_H_ */
@@ -14,6 +14,104 @@ Define_Module(LteRlcUm);
 
 using namespace omnetpp;
 
+LteRlcUm::~LteRlcUm()
+{
+    // pooled entities are owned by this module
+    if (pooledEntities_)
+    {
+        UmTxEntities::iterator tit = txEntities_.begin();
+        for (; tit != txEntities_.end(); ++tit)
+            delete tit->second;
+        UmRxEntities::iterator rit = rxEntities_.begin();
+        for (; rit != rxEntities_.end(); ++rit)
+            delete rit->second;
+    }
+}
+
+UmTxEntity* LteRlcUm::createTxEntity(const char* name)
+{
+    std::chrono::steady_clock::time_point start;
+    if (entityProfiling_)
+        start = std::chrono::steady_clock::now();
+
+    UmTxEntity* txEnt;
+    if (pooledEntities_)
+    {
+        txEnt = txEntityPool_.acquire(name);
+        txEnt->initialize();
+    }
+    else
+    {
+        cModuleType* moduleType = cModuleType::get("lte.stack.rlc.UmTxEntity");
+        LteRlcEntityHost* host = check_and_cast<LteRlcEntityHost *>(moduleType->createScheduleInit(name, getParentModule()));
+        txEnt = new UmTxEntity(host);
+        txEnt->setName(name);
+        host->setEntity(txEnt);
+    }
+
+    if (entityProfiling_)
+        entityProfile_.addCreation(std::chrono::steady_clock::now() - start);
+
+    return txEnt;
+}
+
+UmRxEntity* LteRlcUm::createRxEntity(const char* name)
+{
+    std::chrono::steady_clock::time_point start;
+    if (entityProfiling_)
+        start = std::chrono::steady_clock::now();
+
+    UmRxEntity* rxEnt;
+    if (pooledEntities_)
+    {
+        rxEnt = rxEntityPool_.acquire(name);
+        rxEnt->initialize();
+    }
+    else
+    {
+        cModuleType* moduleType = cModuleType::get("lte.stack.rlc.UmRxEntity");
+        LteRlcEntityHost* host = check_and_cast<LteRlcEntityHost *>(moduleType->createScheduleInit(name, getParentModule()));
+        rxEnt = new UmRxEntity(host);
+        rxEnt->setName(name);
+        host->setEntity(rxEnt);
+    }
+
+    if (entityProfiling_)
+        entityProfile_.addCreation(std::chrono::steady_clock::now() - start);
+
+    return rxEnt;
+}
+
+void LteRlcUm::deleteTxEntity(UmTxEntity* txEnt)
+{
+    std::chrono::steady_clock::time_point start;
+    if (entityProfiling_)
+        start = std::chrono::steady_clock::now();
+
+    if (pooledEntities_)
+        txEntityPool_.release(txEnt);
+    else
+        txEnt->getModule()->deleteModule();    // the host deletes the entity
+
+    if (entityProfiling_)
+        entityProfile_.addDeletion(std::chrono::steady_clock::now() - start);
+}
+
+void LteRlcUm::deleteRxEntity(UmRxEntity* rxEnt)
+{
+    std::chrono::steady_clock::time_point start;
+    if (entityProfiling_)
+        start = std::chrono::steady_clock::now();
+
+    if (pooledEntities_)
+        rxEntityPool_.release(rxEnt);
+    else
+        rxEnt->getModule()->deleteModule();    // the host deletes the entity
+
+    if (entityProfiling_)
+        entityProfile_.addDeletion(std::chrono::steady_clock::now() - start);
+}
+
 UmTxEntity* LteRlcUm::getTxBuffer(FlowControlInfo* lteInfo)
 {
     MacNodeId nodeId = ctrlInfoToUeId(lteInfo);
@@ -40,8 +138,7 @@ UmTxEntity* LteRlcUm::getTxBuffer(FlowControlInfo* lteInfo)
         // FIXME HERE
 
         buf << "UmTxEntity Lcid: " << lcid;
-        cModuleType* moduleType = cModuleType::get("lte.stack.rlc.UmTxEntity");
-        UmTxEntity* txEnt = check_and_cast<UmTxEntity *>(moduleType->createScheduleInit(buf.str().c_str(), getParentModule()));
+        UmTxEntity* txEnt = createTxEntity(buf.str().c_str());
         txEntities_[cid] = txEnt;    // Add to tx_entities map
 
         if (lteInfo != NULL)
@@ -50,7 +147,7 @@ UmTxEntity* LteRlcUm::getTxBuffer(FlowControlInfo* lteInfo)
             txEnt->setFlowControlInfo(lteInfo->dup());
         }
 
-        EV << "LteRlcUm : Added new UmTxEntity: " << txEnt->getId() <<
+        EV << "LteRlcUm : Added new UmTxEntity: " << txEnt->getName() <<
         " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         return txEnt;
@@ -58,7 +155,7 @@ UmTxEntity* LteRlcUm::getTxBuffer(FlowControlInfo* lteInfo)
     else
     {
         // Found
-        EV << "LteRlcUm : Using old UmTxBuffer: " << it->second->getId() <<
+        EV << "LteRlcUm : Using old UmTxBuffer: " << it->second->getName() <<
         " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         return it->second;
@@ -84,15 +181,13 @@ UmRxEntity* LteRlcUm::getRxBuffer(FlowControlInfo* lteInfo)
         // Not found: create
         std::stringstream buf;
         buf << "UmRxEntity Lcid: " << lcid;
-        cModuleType* moduleType = cModuleType::get("lte.stack.rlc.UmRxEntity");
-        UmRxEntity* rxEnt = check_and_cast<UmRxEntity *>(
-            moduleType->createScheduleInit(buf.str().c_str(), getParentModule()));
+        UmRxEntity* rxEnt = createRxEntity(buf.str().c_str());
         rxEntities_[cid] = rxEnt;    // Add to rx_entities map
 
         // store control info for this flow
         rxEnt->setFlowControlInfo(lteInfo->dup());
 
-        EV << "LteRlcUm : Added new UmRxEntity: " << rxEnt->getId() <<
+        EV << "LteRlcUm : Added new UmRxEntity: " << rxEnt->getName() <<
         " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         return rxEnt;
@@ -100,7 +195,7 @@ UmRxEntity* LteRlcUm::getRxBuffer(FlowControlInfo* lteInfo)
     else
     {
         // Found
-        EV << "LteRlcUm : Using old UmRxEntity: " << it->second->getId() <<
+        EV << "LteRlcUm : Using old UmRxEntity: " << it->second->getName() <<
         " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         return it->second;
@@ -253,7 +348,7 @@ void LteRlcUm::deleteQueues(MacNodeId nodeId)
     {
         if (nodeType == UE || (nodeType == ENODEB && MacCidToNodeId(tit->first) == nodeId))
         {
-            tit->second->deleteModule(); // Delete Entity
+            deleteTxEntity(tit->second); // Delete Entity
             txEntities_.erase(tit++);    // Delete Elem
         }
         else
@@ -265,7 +360,7 @@ void LteRlcUm::deleteQueues(MacNodeId nodeId)
     {
         if (nodeType == UE || (nodeType == ENODEB && MacCidToNodeId(rit->first) == nodeId))
         {
-            rit->second->deleteModule(); // Delete Entity
+            deleteRxEntity(rit->second); // Delete Entity
             rxEntities_.erase(rit++);    // Delete Elem
         }
         else
@@ -290,6 +385,10 @@ void LteRlcUm::initialize(int stage)
 
         // parameters
         mapAllLcidsToSingleBearer_ = par("mapAllLcidsToSingleBearer");
+        pooledEntities_ = par("pooledEntities");
+        entityProfiling_ = par("entityProfiling");
+        txEntityPool_.setModule(this);
+        rxEntityPool_.setModule(this);
 
         // statistics
         receivedPacketFromUpperLayer = registerSignal("receivedPacketFromUpperLayer");
@@ -306,6 +405,14 @@ void LteRlcUm::initialize(int stage)
 
 void LteRlcUm::handleMessage(cMessage* msg)
 {
+    if (msg->isSelfMessage())
+    {
+        // timer of a pooled entity
+        LteRlcEntity* entity = static_cast<LteRlcEntity*>(msg->getContextPointer());
+        entity->handleMessage(msg);
+        return;
+    }
+
     cPacket* pkt = check_and_cast<cPacket *>(msg);
     EV << "LteRlcUm : Received packet " << pkt->getName() << " from port " << pkt->getArrivalGate()->getName() << endl;
 
@@ -320,3 +427,16 @@ void LteRlcUm::handleMessage(cMessage* msg)
     }
     return;
 }
+
+void LteRlcUm::finish()
+{
+    if (!entityProfiling_)
+        return;
+
+    entityProfile_.record(this);
+    if (pooledEntities_)
+    {
+        recordScalar("rlcEntitiesAllocated", txEntityPool_.getAllocated() + rxEntityPool_.getAllocated());
+        recordScalar("rlcEntitiesReused", txEntityPool_.getReused() + rxEntityPool_.getReused());
+    }
+}
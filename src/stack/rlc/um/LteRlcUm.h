@@ -18,6 +18,7 @@
 #include "stack/rlc/um/entity/UmRxEntity.h"
 #include "stack/rlc/packet/LteRlcDataPdu.h"
 #include "stack/mac/layer/LteMacBase.h"
+#include "stack/rlc/LteRlcEntity.h"
 
 class UmTxEntity;
 class UmRxEntity;
@@ -42,16 +43,20 @@ class UmRxEntity;
  *   UM mode attaches an header to the packet. The size
  *   of this header is fixed to 2 bytes.
  *
+ *   TX/RX entities run in their own submodules, unless the
+ *   pooledEntities parameter is set: in that case they run in
+ *   this module and are recycled through per-module pools.
+ *
  */
-class LteRlcUm : public omnetpp::cSimpleModule
+class LteRlcUm : public omnetpp::cSimpleModule, public LteRlcEntityOwner
 {
   public:
     LteRlcUm()
     {
+        pooledEntities_ = false;
+        entityProfiling_ = false;
     }
-    virtual ~LteRlcUm()
-    {
-    }
+    virtual ~LteRlcUm();
 
     /**
      * sendFragmented() is invoked by the TXBuffer as a direct method
@@ -106,9 +111,10 @@ class LteRlcUm : public omnetpp::cSimpleModule
      */
     virtual void initialize(int stage) override;
 
-    virtual void finish() override
-    {
-    }
+    virtual void finish() override;
+
+    virtual void takeObj(omnetpp::cOwnedObject* obj) override { take(obj); }
+    virtual void dropObj(omnetpp::cOwnedObject* obj) override { drop(obj); }
 
     /**
      * Analyze gate of incoming packet
@@ -132,6 +138,25 @@ class LteRlcUm : public omnetpp::cSimpleModule
     // parameters
     bool mapAllLcidsToSingleBearer_;
 
+    // if true, entities run in this module and are drawn from the pools below
+    bool pooledEntities_;
+    LteRlcEntityPool<UmTxEntity> txEntityPool_;
+    LteRlcEntityPool<UmRxEntity> rxEntityPool_;
+
+    // if true, the wall-clock cost of creating and deleting entities is recorded
+    bool entityProfiling_;
+    LteRlcEntityProfile entityProfile_;
+
+    /**
+     * createTxEntity()/createRxEntity() return a new, initialized entity,
+     * either hosted by a new submodule or drawn from the pool.
+     * deleteTxEntity()/deleteRxEntity() dispose of an entity accordingly
+     */
+    UmTxEntity* createTxEntity(const char* name);
+    UmRxEntity* createRxEntity(const char* name);
+    virtual void deleteTxEntity(UmTxEntity* txEnt);
+    virtual void deleteRxEntity(UmRxEntity* rxEnt);
+
     /**
      * getTxBuffer() is used by the sender to gather the TXBuffer
      * for that CID. If TXBuffer was already present, a reference
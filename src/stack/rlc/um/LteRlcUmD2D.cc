@@ -28,8 +28,7 @@ UmTxEntity* LteRlcUmD2D::getTxBuffer(FlowControlInfo* lteInfo)
         // FIXME HERE
 
         buf << "UmTxEntity Lcid: " << lcid;
-        cModuleType* moduleType = cModuleType::get("lte.stack.rlc.UmTxEntity");
-        UmTxEntity* txEnt = check_and_cast<UmTxEntity *>(moduleType->createScheduleInit(buf.str().c_str(), getParentModule()));
+        UmTxEntity* txEnt = createTxEntity(buf.str().c_str());
         txEntities_[cid] = txEnt;    // Add to tx_entities map
 
         if (lteInfo != NULL)
@@ -38,7 +37,7 @@ UmTxEntity* LteRlcUmD2D::getTxBuffer(FlowControlInfo* lteInfo)
             txEnt->setFlowControlInfo(lteInfo->dup());
         }
 
-        EV << "LteRlcUmD2D : Added new UmTxEntity: " << txEnt->getId() <<
+        EV << "LteRlcUmD2D : Added new UmTxEntity: " << txEnt->getName() <<
         " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         // store per-peer map
@@ -54,13 +53,22 @@ UmTxEntity* LteRlcUmD2D::getTxBuffer(FlowControlInfo* lteInfo)
     else
     {
         // Found
-        EV << "LteRlcUmD2D : Using old UmTxBuffer: " << it->second->getId() <<
+        EV << "LteRlcUmD2D : Using old UmTxBuffer: " << it->second->getName() <<
         " for node: " << nodeId << " for Lcid: " << lcid << "\n";
 
         return it->second;
     }
 }
 
+void LteRlcUmD2D::deleteTxEntity(UmTxEntity* txEnt)
+{
+    std::map<MacNodeId, std::set<UmTxEntity*> >::iterator it = perPeerTxEntities_.begin();
+    for (; it != perPeerTxEntities_.end(); ++it)
+        it->second.erase(txEnt);
+
+    LteRlcUm::deleteTxEntity(txEnt);
+}
+
 void LteRlcUmD2D::handleLowerMessage(cPacket *pkt)
 {
     if (strcmp(pkt->getName(), "D2DModeSwitchNotification") == 0)
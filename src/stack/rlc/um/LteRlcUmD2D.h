@@ -49,6 +49,12 @@ class LteRlcUmD2D : public LteRlcUm
      */
     virtual UmTxEntity* getTxBuffer(FlowControlInfo* lteInfo) override;
 
+    /**
+     * Removes the entity from the per-peer map before deleting it,
+     * as pooled entities are reused for other flows
+     */
+    virtual void deleteTxEntity(UmTxEntity* txEnt) override;
+
     /**
      * UM Mode
      *
@@ -12,22 +12,21 @@
 #include "stack/mac/layer/LteMacBase.h"
 #include "stack/mac/layer/LteMacEnb.h"
 
-Define_Module(UmRxEntity);
-
 using namespace omnetpp;
 
 unsigned int UmRxEntity::totalCellPduRcvdBytes_ = 0;
 unsigned int UmRxEntity::totalCellRcvdBytes_ = 0;
 
-UmRxEntity::UmRxEntity() :
-    t_reordering_(this)
+UmRxEntity::UmRxEntity(cSimpleModule* module) :
+    LteRlcEntity(module), t_reordering_(module)
 {
     t_reordering_.setTimerId(REORDERING_T);
+    t_reordering_.setContextPointer(this);
     buffered_ = NULL;
-    lastSnoDelivered_ = 0;
-    lastPduReassembled_ = 0;
+    flowControlInfo_ = NULL;
     nodeB_ = NULL;
-    init_ = false;
+
+    take(&pduBuffer_);
 }
 
 UmRxEntity::~UmRxEntity()
@@ -40,7 +39,7 @@ UmRxEntity::~UmRxEntity()
 
 void UmRxEntity::enque(cPacket* pkt)
 {
-    Enter_Method("enque()");
+    Enter_Entity_Method("enque()");
     EV << NOW << " UmRxEntity::enque - buffering new PDU" << endl;
 
     LteRlcUmDataPdu* pdu = check_and_cast<LteRlcUmDataPdu*>(pkt);
@@ -65,7 +64,7 @@ void UmRxEntity::enque(cPacket* pkt)
     EV << NOW << " UmRxEntity::enque - tsn " << tsn << ", the corresponding index in the buffer is " << index << endl;
 
     // x was already received
-    if (tsn >= rxWindowDesc_.firstSnoForReordering_ && tsn < rxWindowDesc_.highestReceivedSno_ && received_.at(index) == true)
+    if (tsn >= rxWindowDesc_.firstSnoForReordering_ && tsn < rxWindowDesc_.highestReceivedSno_ && received_.at(rxRing_.slot(index)) == true)
     {
         EV << NOW << " UmRxEntity::enque the received PDU has index " << index << " which points to an already busy location. Discard the PDU" << endl;
 
@@ -132,8 +131,8 @@ void UmRxEntity::enque(cPacket* pkt)
     // buffer the received PDU at the correct position in the buffer
     // get the position in the buffer (the buffer may has been shifted)
     index = tsn - rxWindowDesc_.firstSno_;
-    pduBuffer_.addAt(index, pdu);
-    received_.at(index) = true;
+    pduBuffer_.addAt(rxRing_.slot(index), pdu);
+    received_.at(rxRing_.slot(index)) = true;
 
     // emit statistics
     MacNodeId ueId;
@@ -162,14 +161,14 @@ void UmRxEntity::enque(cPacket* pkt)
     index = rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_; //
 
     // D
-    if (received_.at(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_) == true)
+    if (received_.at(rxRing_.slot(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_)) == true)
     {
         unsigned int old = rxWindowDesc_.firstSnoForReordering_;
 
         index = rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_; //
 
         // move to the first missing SN
-        while (received_.at(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_) == true)
+        while (received_.at(rxRing_.slot(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_)) == true)
         {
             rxWindowDesc_.firstSnoForReordering_++;
             if (rxWindowDesc_.firstSnoForReordering_ == rxWindowDesc_.highestReceivedSno_) // end of the window
@@ -216,19 +215,16 @@ void UmRxEntity::moveRxWindow(const int pos)
     if (pos>rxWindowDesc_.windowSize_)
         throw cRuntimeError("AmRxQueue::moveRxWindow(): positions %d win size %d ",pos,rxWindowDesc_.windowSize_);
 
-    for (unsigned int i = pos; i < rxWindowDesc_.windowSize_; ++i)
+    // the PDUs leaving the window have already been reassembled: clear their slots,
+    // which are reused for the positions entering the window
+    for (int i = 0; i < pos; ++i)
     {
-        if (pduBuffer_.get(i) != NULL)
-        {
-            pduBuffer_.addAt(i-pos, pduBuffer_.remove(i));
-        }
-        else
-        {
-            pduBuffer_.remove(i);
-        }
-        received_.at(i-pos) = received_.at(i);
-        received_.at(i) = false;
+        unsigned int slot = rxRing_.slot(i);
+        if (pduBuffer_.get(slot) != NULL)
+            delete pduBuffer_.remove(slot);
+        received_.at(slot) = false;
     }
+    rxRing_.advance(pos);
 
     rxWindowDesc_.firstSno_ += pos;
 
@@ -238,7 +234,7 @@ void UmRxEntity::moveRxWindow(const int pos)
 
 void UmRxEntity::toPdcp(LteRlcSdu* rlcSdu)
 {
-    LteRlcUm* lteRlc = check_and_cast<LteRlcUm*>(getParentModule()->getSubmodule("um"));
+    LteRlcUm* lteRlc = check_and_cast<LteRlcUm*>(module_->getParentModule()->getSubmodule("um"));
 
     FlowControlInfo* lteInfo = check_and_cast<FlowControlInfo*>(rlcSdu->getControlInfo());
     unsigned int sno = rlcSdu->getSnoMainPacket();
@@ -313,7 +309,7 @@ void UmRxEntity::toPdcp(LteRlcSdu* rlcSdu)
 
 void UmRxEntity::reassemble(unsigned int index)
 {
-    if (received_.at(index) == false)
+    if (received_.at(rxRing_.slot(index)) == false)
     {
         // consider the case when a PDU is missing or already delivered
         EV << NOW << " UmRxEntity::reassemble PDU at index " << index << " has not been received or already delivered" << endl;
@@ -321,7 +317,7 @@ void UmRxEntity::reassemble(unsigned int index)
     }
     EV << NOW << " UmRxEntity::reassemble Consider PDU at index " << index << " for reassembly" << endl;
 
-    LteRlcUmDataPdu* pdu = check_and_cast<LteRlcUmDataPdu*>(pduBuffer_.get(index));
+    LteRlcUmDataPdu* pdu = check_and_cast<LteRlcUmDataPdu*>(pduBuffer_.get(rxRing_.slot(index)));
     FlowControlInfo* lteInfo = check_and_cast<FlowControlInfo*>(pdu->removeControlInfo());
 
     // get PDU seq number
@@ -343,10 +339,15 @@ void UmRxEntity::reassemble(unsigned int index)
     // for each SDU
     for (unsigned int i=0; i<numSdu; i++)
     {
-        LteRlcSdu* rlcSdu = check_and_cast<LteRlcSdu*>(pdu->popSdu());
-        unsigned int sduSno = rlcSdu->getSnoMainPacket();
-        unsigned int sduWholeLength = rlcSdu->getLengthMainPacket(); // the length of the whole sdu
-        unsigned int sduLength = rlcSdu->getByteLength();
+        cPacket* pkt = pdu->popSdu();
+        LteRlcSduSegment* segment = dynamic_cast<LteRlcSduSegment*>(pkt);
+
+        // the SDU carried by this chunk, i.e. a whole SDU or the one completed by the last segment
+        LteRlcSdu* rlcSdu = (segment == NULL) ? check_and_cast<LteRlcSdu*>(pkt) : segment->removeSdu();
+
+        unsigned int sduSno = (segment == NULL) ? rlcSdu->getSnoMainPacket() : segment->getSnoMainPacket();
+        unsigned int sduWholeLength = (segment == NULL) ? rlcSdu->getLengthMainPacket() : segment->getLengthMainPacket(); // the length of the whole sdu
+        unsigned int sduLength = pkt->getByteLength();
 
         if (i==0) // first SDU
         {
@@ -389,8 +390,9 @@ void UmRxEntity::reassemble(unsigned int index)
                             buffered_ = NULL;
                         }
 
-                        // buffer the SDU and wait for the missing portion
-                        buffered_ = rlcSdu->dup();
+                        // buffer the segment and wait for the missing portion
+                        buffered_ = check_and_cast<LteRlcSduSegment*>(pkt);
+                        segment = NULL;
                         EV << NOW << " UmRxEntity::reassemble Wait for the missing part..." << endl;
 
                         break;
@@ -400,7 +402,7 @@ void UmRxEntity::reassemble(unsigned int index)
                         EV << NOW << " UmRxEntity::reassemble The PDU includes the last part [" << sduLength <<" B] of a SDU [sno=" << sduSno << "]" << endl;
 
                         // check SDU SN
-                        if (buffered_ == NULL || (rlcSdu->getSnoMainPacket() != buffered_->getSnoMainPacket()) || ignoreFragment)
+                        if (buffered_ == NULL || (sduSno != buffered_->getSnoMainPacket()) || ignoreFragment)
                         {
                             if (buffered_ != NULL)
                             {
@@ -411,13 +413,14 @@ void UmRxEntity::reassemble(unsigned int index)
                             EV << NOW << " UmRxEntity::reassemble The SDU cannot be reassembled, first part missing" << endl;
 
                             delete rlcSdu;
+                            delete segment;
 
                             continue;
                         }
 
                         EV << NOW << " UmRxEntity::reassemble The waiting SDU has size " <<  buffered_->getByteLength() << " bytes" << endl;
 
-                        unsigned int reassembledLength = buffered_->getByteLength() + rlcSdu->getByteLength();
+                        unsigned int reassembledLength = buffered_->getByteLength() + sduLength;
                         if (reassembledLength < sduWholeLength)
                         {
                             if (buffered_ != NULL)
@@ -429,6 +432,7 @@ void UmRxEntity::reassemble(unsigned int index)
                             EV << NOW << " UmRxEntity::reassemble The SDU cannot be reassembled, mid part missing" << endl;
 
                             delete rlcSdu;
+                            delete segment;
 
                             continue;
                         }
@@ -436,8 +440,9 @@ void UmRxEntity::reassemble(unsigned int index)
                         {
                             throw cRuntimeError("UmRxEntity::reassemble(): failed reassembly, the reassembled SDU has size %d B, while the original SDU had size %d B",sduLength,sduWholeLength);
                         }
-                        rlcSdu->setByteLength(reassembledLength);
-//                        rlcSdu->setByteLength(buffered_->getByteLength() + rlcSdu->getByteLength());
+                        // the last segment carries the whole SDU
+                        if (rlcSdu == NULL)
+                            throw cRuntimeError("UmRxEntity::reassemble(): failed reassembly, the last segment of SDU %d does not carry the SDU",sduSno);
 
                         toPdcp(rlcSdu);
 
@@ -454,7 +459,7 @@ void UmRxEntity::reassemble(unsigned int index)
                         EV << NOW << " UmRxEntity::reassemble The PDU includes the mid part [" << sduLength <<" B] of a SDU [sno=" << sduSno << "]" << endl;
 
                         // check SDU SN
-                        if (buffered_ == NULL || (rlcSdu->getSnoMainPacket() != buffered_->getSnoMainPacket()))
+                        if (buffered_ == NULL || (sduSno != buffered_->getSnoMainPacket()))
                         {
                             if (buffered_ != NULL)
                             {
@@ -465,11 +470,12 @@ void UmRxEntity::reassemble(unsigned int index)
                             EV << NOW << " UmRxEntity::reassemble The SDU cannot be reassembled, first part missing" << endl;
 
                             delete rlcSdu;
+                            delete segment;
 
                             continue;
                         }
 
-                        buffered_->setByteLength(buffered_->getByteLength() + rlcSdu->getByteLength());
+                        buffered_->setByteLength(buffered_->getByteLength() + sduLength);
 
                         EV << NOW << " UmRxEntity::reassemble The waiting SDU has size " << buffered_->getByteLength() << " bytes, was " <<  buffered_->getByteLength() - sduLength << " bytes" << endl;
                         EV << NOW << " UmRxEntity::reassemble Wait for the missing part..." << endl;
@@ -509,7 +515,7 @@ void UmRxEntity::reassemble(unsigned int index)
                         EV << NOW << " UmRxEntity::reassemble This is the last part [" << sduLength <<" B] of a SDU [sno=" << sduSno << "]" << endl;
 
                         // check SDU SN
-                        if (buffered_ == NULL || (rlcSdu->getSnoMainPacket() != buffered_->getSnoMainPacket()) || ignoreFragment)
+                        if (buffered_ == NULL || (sduSno != buffered_->getSnoMainPacket()) || ignoreFragment)
                         {
                             if (buffered_ != NULL)
                             {
@@ -520,13 +526,14 @@ void UmRxEntity::reassemble(unsigned int index)
                             EV << NOW << " UmRxEntity::reassemble The SDU cannot be reassembled, first part missing" << endl;
 
                             delete rlcSdu;
+                            delete segment;
 
                             continue;
                         }
 
                         EV << NOW << " UmRxEntity::reassemble The waiting SDU has size " <<  buffered_->getByteLength() << " bytes" << endl;
 
-                        unsigned int reassembledLength = buffered_->getByteLength() + rlcSdu->getByteLength();
+                        unsigned int reassembledLength = buffered_->getByteLength() + sduLength;
                         if (reassembledLength < sduWholeLength)
                         {
                             if (buffered_ != NULL)
@@ -538,6 +545,7 @@ void UmRxEntity::reassemble(unsigned int index)
                             EV << NOW << " UmRxEntity::reassemble The SDU cannot be reassembled, mid part missing" << endl;
 
                             delete rlcSdu;
+                            delete segment;
 
                             continue;
                         }
@@ -545,8 +553,9 @@ void UmRxEntity::reassemble(unsigned int index)
                         {
                             throw cRuntimeError("UmRxEntity::reassemble(): failed reassembly, the reassembled SDU has size %d B, while the original SDU had size %d B",sduLength,sduWholeLength);
                         }
-                        rlcSdu->setByteLength(reassembledLength);
-//                        rlcSdu->setByteLength(buffered_->getByteLength() + rlcSdu->getByteLength());
+                        // the last segment carries the whole SDU
+                        if (rlcSdu == NULL)
+                            throw cRuntimeError("UmRxEntity::reassemble(): failed reassembly, the last segment of SDU %d does not carry the SDU",sduSno);
 
                         toPdcp(rlcSdu);
 
@@ -593,7 +602,9 @@ void UmRxEntity::reassemble(unsigned int index)
                         buffered_ = NULL;
                     }
 
-                    buffered_ = rlcSdu->dup();
+                    // buffer the segment
+                    buffered_ = check_and_cast<LteRlcSduSegment*>(pkt);
+                    segment = NULL;
 
                     EV << NOW << " UmRxEntity::reassemble Wait for the missing part..." << endl;
 
@@ -619,11 +630,11 @@ void UmRxEntity::reassemble(unsigned int index)
         }
 
         delete rlcSdu;
-
+        delete segment;
     }
     // remove PDU from buffer
-    pduBuffer_.remove(index);
-    received_.at(index) = false;
+    pduBuffer_.remove(rxRing_.slot(index));
+    received_.at(rxRing_.slot(index)) = false;
     EV << NOW << " UmRxEntity::reassemble Removed PDU from position " << index << endl;
 
     // emit statistics
@@ -677,14 +688,20 @@ void UmRxEntity::initialize()
     timeout_ = par("timeout").doubleValue();
     rxWindowDesc_.clear();
     rxWindowDesc_.windowSize_ = par("rxWindowSize");
-    received_.resize(rxWindowDesc_.windowSize_);
+    rxRing_.init(rxWindowDesc_.windowSize_);
+    received_.assign(rxRing_.size(), false);
+
+    buffered_ = NULL;
+    lastSnoDelivered_ = 0;
+    lastPduReassembled_ = 0;
+    init_ = false;
 
     totalRcvdBytes_ = 0;
     totalPduRcvdBytes_ = 0;
 
-    cModule* parent = check_and_cast<LteRlcUm*>(getParentModule()->getSubmodule("um"));
+    cModule* parent = check_and_cast<LteRlcUm*>(module_->getParentModule()->getSubmodule("um"));
     //statistics
-    LteMacBase* mac = check_and_cast<LteMacBase*>(getParentModule()->getParentModule()->getSubmodule("mac"));
+    LteMacBase* mac = check_and_cast<LteMacBase*>(module_->getParentModule()->getParentModule()->getSubmodule("mac"));
 
     nodeB_ = getRlcByMacNodeId(mac->getMacCellId(), UM);
 
@@ -730,7 +747,26 @@ void UmRxEntity::initialize()
     // store the node id of the owner module (useful for statistics)
     ownerNodeId_ = mac->getMacNodeId();
 
-    WATCH(timeout_);
+    // watches would pile up in the RLC module as pooled entities are reused
+    if (!isPooled())
+        WATCH(timeout_);
+}
+
+void UmRxEntity::clear()
+{
+    pduBuffer_.clear();
+
+    if (buffered_ != NULL)
+    {
+        delete buffered_;
+        buffered_ = NULL;
+    }
+
+    if (t_reordering_.busy())
+        t_reordering_.stop();
+
+    delete flowControlInfo_;
+    flowControlInfo_ = NULL;
 }
 
 void UmRxEntity::handleMessage(cMessage* msg)
@@ -744,7 +780,7 @@ void UmRxEntity::handleMessage(cMessage* msg)
         unsigned int old = rxWindowDesc_.firstSnoForReordering_;
 
         // move to the first missing SN
-        while (received_.at(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_) == true
+        while (received_.at(rxRing_.slot(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_)) == true
                  || rxWindowDesc_.firstSnoForReordering_ < rxWindowDesc_.reorderingSno_)
         {
             rxWindowDesc_.firstSnoForReordering_++;
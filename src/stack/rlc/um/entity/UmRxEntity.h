@@ -16,6 +16,8 @@
 #include "common/LteControlInfo.h"
 #include "stack/pdcp_rrc/packet/LtePdcpPdu_m.h"
 #include "stack/rlc/LteRlcDefs.h"
+#include "stack/rlc/LteRlcEntity.h"
+#include "stack/rlc/packet/LteRlcSduSegment.h"
 
 class LteMacBase;
 class LteRlcUm;
@@ -30,10 +32,10 @@ class LteRlcUmDataPdu;
  *
  * It implements the procedures described in 3GPP TS 36.322
  */
-class UmRxEntity : public omnetpp::cSimpleModule
+class UmRxEntity : public LteRlcEntity
 {
   public:
-    UmRxEntity();
+    UmRxEntity(omnetpp::cSimpleModule* module);
     virtual ~UmRxEntity();
 
     /*
@@ -48,13 +50,19 @@ class UmRxEntity : public omnetpp::cSimpleModule
     // called when a D2D mode switch is triggered
     void rlcHandleD2DModeSwitch(bool oldConnection, bool oldMode, bool clearBuffer=true);
 
-  protected:
-
     /**
      * Initialize watches
      */
-    virtual void initialize();
-    virtual void handleMessage(omnetpp::cMessage* msg);
+    virtual void initialize() override;
+    virtual void handleMessage(omnetpp::cMessage* msg) override;
+
+    /**
+     * Clear the PDU buffer, stop the reordering timer
+     * and delete the flow-related info
+     */
+    virtual void clear() override;
+
+  protected:
 
     //Statistics
     static unsigned int totalCellPduRcvdBytes_;
@@ -111,8 +119,11 @@ class UmRxEntity : public omnetpp::cSimpleModule
     // For each PDU a received status variable is kept.
     std::vector<bool> received_;
 
+    // Ring indexing of pduBuffer_ and received_ by window position
+    RlcWindowRing rxRing_;
+
     // The SDU waiting for the missing portion
-    LteRlcSdu* buffered_;
+    LteRlcSduSegment* buffered_;
 
     // Sequence number of the last SDU delivered to the upper layer
     unsigned int lastSnoDelivered_;
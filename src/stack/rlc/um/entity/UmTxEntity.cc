@@ -8,11 +8,20 @@
 //
 
 #include "stack/rlc/um/entity/UmTxEntity.h"
-
-Define_Module(UmTxEntity);
+#include "stack/rlc/packet/LteRlcSduSegment.h"
 
 using namespace omnetpp;
 
+UmTxEntity::UmTxEntity(cSimpleModule* module) :
+    LteRlcEntity(module)
+{
+    flowControlInfo_ = NULL;
+    lteRlc_ = NULL;
+
+    take(&sduQueue_);
+    take(&sduHoldingQueue_);
+}
+
 /*
  * Main functions
  */
@@ -20,20 +29,29 @@ using namespace omnetpp;
 void UmTxEntity::initialize()
 {
     sno_ = 0;
-    firstIsFragment_ = false;
+    fragmentOffset_ = 0;
     notifyEmptyBuffer_ = false;
     holdingDownstreamInPackets_ = false;
 
     // store the node id of the owner module
-    LteMacBase* mac = check_and_cast<LteMacBase*>(getParentModule()->getParentModule()->getSubmodule("mac"));
+    LteMacBase* mac = check_and_cast<LteMacBase*>(module_->getParentModule()->getParentModule()->getSubmodule("mac"));
     ownerNodeId_ = mac->getMacNodeId();
 
     // get the reference to the RLC module
-    lteRlc_ = check_and_cast<LteRlcUm*>(getParentModule()->getSubmodule("um"));
+    lteRlc_ = check_and_cast<LteRlcUm*>(module_->getParentModule()->getSubmodule("um"));
     queueSize_ = lteRlc_->par("queueSize");
     queueLength_ = 0;
 }
 
+void UmTxEntity::clear()
+{
+    clearQueue();
+    sduHoldingQueue_.clear();
+
+    delete flowControlInfo_;
+    flowControlInfo_ = NULL;
+}
+
 bool UmTxEntity::enque(cPacket* pkt)
 {
     EV << NOW << " UmTxEntity::enque - bufferize new SDU  " << endl;
@@ -61,7 +79,7 @@ void UmTxEntity::rlcPduMake(int pduLength)
 
     int len = 0;
 
-    bool startFrag = firstIsFragment_;
+    bool startFrag = (fragmentOffset_ > 0);
     bool endFrag = false;
 
     while (!sduQueue_.isEmpty() && pduLength > 0)
@@ -71,7 +89,8 @@ void UmTxEntity::rlcPduMake(int pduLength)
         LteRlcSdu* rlcSdu = check_and_cast<LteRlcSdu*>(pkt);
 
         unsigned int sduSequenceNumber = rlcSdu->getSnoMainPacket();
-        int sduLength = rlcSdu->getByteLength();
+        // bytes of the SDU still to be sent
+        int sduLength = rlcSdu->getByteLength() - fragmentOffset_;
 
         EV << NOW << " UmTxEntity::rlcPduMake - Next data chunk from the queue, sduSno[" << sduSequenceNumber
                 << "], length[" << sduLength << "]"<< endl;
@@ -87,12 +106,22 @@ void UmTxEntity::rlcPduMake(int pduLength)
             sduQueue_.pop();
             queueLength_ -= sduLength;
 
-            rlcPdu->pushSdu(rlcSdu);
+            if (fragmentOffset_ == 0)
+            {
+                rlcPdu->pushSdu(rlcSdu);
+            }
+            else
+            {
+                // last segment of the SDU: it carries the SDU itself
+                LteRlcSduSegment* segment = new LteRlcSduSegment(rlcSdu, fragmentOffset_, sduLength);
+                segment->setSdu(rlcSdu);
+                rlcPdu->pushSdu(segment);
+            }
 
             EV << NOW << " UmTxEntity::rlcPduMake - Pop data chunk from the queue, sduSno[" << sduSequenceNumber << "]" << endl;
 
             // now, the first SDU in the buffer is not a fragment
-            firstIsFragment_ = false;
+            fragmentOffset_ = 0;
 
             EV << NOW << " UmTxEntity::rlcPduMake - The new SDU has length " << len << ", left space is " << pduLength << endl;
         }
@@ -104,24 +133,20 @@ void UmTxEntity::rlcPduMake(int pduLength)
 
             len += pduLength;
 
-            LteRlcSdu* rlcSduDup = rlcSdu->dup();
-            rlcSduDup->setByteLength(pduLength);
-            rlcPdu->pushSdu(rlcSduDup);
+            // the segment only describes the portion of the SDU, which stays in the buffer
+            rlcPdu->pushSdu(new LteRlcSduSegment(rlcSdu, fragmentOffset_, pduLength));
 
             endFrag = true;
 
-            // update SDU in the buffer
+            // update SDU in the buffer: now, the first SDU in the buffer is a fragment
             int newLength = sduLength - pduLength;
-            pkt->setByteLength(newLength);
+            fragmentOffset_ += pduLength;
             queueLength_ -= pduLength;
 
             EV << NOW << " UmTxEntity::rlcPduMake - Data chunk in the queue is now " << newLength << " bytes, sduSno[" << sduSequenceNumber << "]" << endl;
 
             pduLength = 0;
 
-            // now, the first SDU in the buffer is a fragment
-            firstIsFragment_ = true;
-
             EV << NOW << " UmTxEntity::rlcPduMake - The new SDU has length " << len << ", left space is " << pduLength << endl;
 
         }
@@ -180,6 +205,12 @@ void UmTxEntity::removeDataFromQueue()
     // ...and remove it
     cPacket* retPkt = sduQueue_.remove(pkt);
     queueLength_ -= retPkt->getByteLength();
+    if (sduQueue_.isEmpty())
+    {
+        // it was the first SDU, part of which may have been already sent
+        queueLength_ += fragmentOffset_;
+        fragmentOffset_ = 0;
+    }
     delete retPkt;
 }
 
@@ -192,7 +223,7 @@ void UmTxEntity::clearQueue()
     queueLength_ = 0;
 
     // reset variables except for sequence number
-    firstIsFragment_ = false;
+    fragmentOffset_ = 0;
 }
 
 bool UmTxEntity::isHoldingDownstreamInPackets()
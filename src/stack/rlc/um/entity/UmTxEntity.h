@@ -13,6 +13,7 @@
 #include <omnetpp.h>
 #include "stack/rlc/um/LteRlcUm.h"
 #include "stack/rlc/LteRlcDefs.h"
+#include "stack/rlc/LteRlcEntity.h"
 
 class LteRlcUm;
 
@@ -39,14 +40,10 @@ class LteRlcUm;
  *
  * The size of PDUs is signalled by the lower layer
  */
-class UmTxEntity : public omnetpp::cSimpleModule
+class UmTxEntity : public LteRlcEntity
 {
   public:
-    UmTxEntity()
-    {
-        flowControlInfo_ = NULL;
-        lteRlc_ = NULL;
-    }
+    UmTxEntity(omnetpp::cSimpleModule* module);
     virtual ~UmTxEntity()
     {
         delete flowControlInfo_;
@@ -115,9 +112,10 @@ class UmTxEntity : public omnetpp::cSimpleModule
     inet::cPacketQueue sduQueue_;
 
     /*
-     * Determine whether the first item in the queue is a fragment or a whole SDU
+     * Number of bytes of the first SDU in the queue already sent within previous PDUs
+     * (i.e. the first item in the queue is a fragment if this is not zero)
      */
-    bool firstIsFragment_;
+    unsigned int fragmentOffset_;
 
     /*
      * If true, the entity check when the queue becomes empty
@@ -145,12 +143,19 @@ class UmTxEntity : public omnetpp::cSimpleModule
      */
     unsigned int queueLength_;
 
+  public:
+
     /**
      * Initialize fragmentSize and
      * watches
      */
     virtual void initialize() override;
 
+    /**
+     * Clear the buffers and the flow-related info
+     */
+    virtual void clear() override;
+
   private:
 
     // Node id of the owner module
@@ -11,6 +11,7 @@
 #include <inet/common/INETMath.h>
 
 #include "stack/phy/packet/AirFrame_m.h"
+#include "stack/phy/packet/LteAirFrame.h"
 #include "world/radio/LteChannelControl.h"
 
 
@@ -78,6 +79,11 @@ void LteChannelControl::sendToChannel(RadioRef srcRadio, AirFrame *airFrame)
 {
     // NOTE: no Enter_Method()! We pretend this method is part of ChannelAccess
 
+    // the copies sent to the neighbors share the control info and the encapsulated packet
+    LteAirFrame* lteFrame = dynamic_cast<LteAirFrame*>(airFrame);
+    if (lteFrame != NULL)
+        lteFrame->shareControlInfo();
+
     // loop through all radios in range
     const RadioRefVector& neighbors = getNeighbors(srcRadio);
     for (unsigned int i=0; i<neighbors.size(); i++)